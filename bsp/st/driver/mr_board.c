@@ -6,8 +6,32 @@
  * @date 2023-11-10    MacRsh       First version
  */
 
+#include "include/mr_api.h"
 #include "mr_board.h"
 
+#ifdef DRV_HEAP_REGION_CONFIG
+struct drv_heap_region_data
+{
+    void *memory;
+    size_t size;
+    int flags;
+    int priority;
+};
+
+static struct drv_heap_region_data heap_region_drv_data[] = DRV_HEAP_REGION_CONFIG;
+
+static void drv_heap_region_init(void)
+{
+    for (size_t i = 0; i < MR_ARRAY_NUM(heap_region_drv_data); i++) {
+        mr_heap_add_region(heap_region_drv_data[i].memory,
+                           heap_region_drv_data[i].size,
+                           heap_region_drv_data[i].flags,
+                           heap_region_drv_data[i].priority);
+    }
+}
+MR_INIT_BOARD_EXPORT(drv_heap_region_init);
+#endif /* DRV_HEAP_REGION_CONFIG */
+
 void mr_delay_ms(uint32_t ms)
 {
     HAL_Delay(ms);
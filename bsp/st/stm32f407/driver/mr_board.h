@@ -15,6 +15,13 @@ extern "C" {
 
 #include "stm32f4xx.h"
 
+#ifdef MR_USING_CCMRAM_HEAP
+#define DRV_HEAP_REGION_CONFIG          \
+    {                                   \
+        {(void *)(CCMDATARAM_BASE + (64 * 1024) - MR_CFG_CCMRAM_HEAP_SIZE), MR_CFG_CCMRAM_HEAP_SIZE, MR_HEAP_FAST, 1}, \
+    }
+#endif /* MR_USING_CCMRAM_HEAP */
+
 #define DRV_ADC_CHANNEL_CONFIG          \
     {                                   \
         {ADC_CHANNEL_0},                \
@@ -607,6 +607,76 @@ static void msh_cmd_dwrite(int argc, void *argv)
     mr_msh_printf("usage: dwrite [-1|-2|-4] [-x|-d|-u|-c] <data>\r\n");
 }
 
+#ifdef MR_USING_DEV_STATS
+static void msh_dstat_print(const char *name, struct mr_dev_op_stats *stats)
+{
+    mr_msh_printf("|%-6s|%-10u|%-8u|%-8u|%-12u|%-10u|\r\n",
+                  name,
+                  stats->count,
+                  stats->errors,
+                  stats->busy,
+                  (uint32_t)stats->bytes,
+                  stats->max_cycles);
+}
+
+static void msh_dstat_print_hist(const char *name, struct mr_dev_op_stats *stats)
+{
+    mr_msh_printf("%-6s", name);
+    for (size_t i = 0; i < MR_CFG_DEV_STATS_HIST_NUM; i++) {
+        mr_msh_printf(" %u", stats->hist[i]);
+    }
+    mr_msh_printf("\r\n");
+}
+
+static void msh_cmd_dstat(int argc, void *argv)
+{
+    struct mr_dev_stats stats;
+    int ret;
+
+    /* Parse [-c|-t] */
+    if ((argc >= 1) && (strncmp(MR_MSH_GET_ARG(1), "-c", 2) == 0)) {
+        ret = mr_dev_ioctl(MSH_GET_DESC(), MR_IOC_CSTAT, MR_NULL);
+        if (ret < 0) {
+            mr_msh_printf("dstat: %s\r\n", mr_strerror(ret));
+        }
+        return;
+    }
+    if ((argc >= 1) && (strncmp(MR_MSH_GET_ARG(1), "-t", 2) != 0)) {
+        goto usage;
+    }
+
+    ret = mr_dev_ioctl(MSH_GET_DESC(), MR_IOC_GSTAT, &stats);
+    if (ret < 0) {
+        mr_msh_printf("dstat: %s\r\n", mr_strerror(ret));
+        return;
+    }
+
+    /* Print the histograms, the bucket n counts the operations of [2^(n-1), 2^n) cycles */
+    if (argc >= 1) {
+        msh_dstat_print_hist("read", &stats.rd);
+        msh_dstat_print_hist("write", &stats.wr);
+        msh_dstat_print_hist("ioctl", &stats.ioctl);
+        msh_dstat_print_hist("isr", &stats.isr);
+        msh_dstat_print_hist("call", &stats.call);
+        return;
+    }
+
+    mr_msh_printf("|%-6s|%-10s|%-8s|%-8s|%-12s|%-10s|\r\n", "op", "count", "errors", "busy", "bytes", "max cycles");
+    msh_dstat_print("read", &stats.rd);
+    msh_dstat_print("write", &stats.wr);
+    msh_dstat_print("ioctl", &stats.ioctl);
+    msh_dstat_print("isr", &stats.isr);
+    msh_dstat_print("call", &stats.call);
+    mr_msh_printf("isr events: read %u, write %u\r\n", stats.rd_events, stats.wr_events);
+    return;
+
+    usage:
+    mr_msh_printf("usage: dstat [-t|-c]\r\n");
+    mr_msh_printf("       [-t]: show the log2 cycles histograms\r\n");
+    mr_msh_printf("       [-c]: clear the statistics\r\n");
+}
+#endif /* MR_USING_DEV_STATS */
+
 /**
  * @brief Exports device MSH commands.
  */
@@ -617,5 +687,8 @@ MR_MSH_CMD_EXPORT(dclose, msh_cmd_dclose, "close a device.");
 MR_MSH_CMD_EXPORT(dioctl, msh_cmd_dioctl, "ioctl a device.");
 MR_MSH_CMD_EXPORT(dread, msh_cmd_dread, "read from a device.");
 MR_MSH_CMD_EXPORT(dwrite, msh_cmd_dwrite, "write to a device.");
+#ifdef MR_USING_DEV_STATS
+MR_MSH_CMD_EXPORT(dstat, msh_cmd_dstat, "show device statistics.");
+#endif /* MR_USING_DEV_STATS */
 
 #endif /* defined(MR_USING_MSH) && defined(MR_USING_MSH_DEV_CMD) */
@@ -0,0 +1,88 @@
+/*
+ * @copyright (c) 2023-2024, MR Development Team
+ *
+ * @license SPDX-License-Identifier: Apache-2.0
+ *
+ * @date 2024-03-18    MacRsh       First version
+ */
+
+#include "include/components/mr_msh.h"
+
+#if defined(MR_USING_MSH) && defined(MR_USING_HEAP_STATS)
+
+static void msh_heap_print_tags(void)
+{
+    struct mr_heap_tag_stats stats;
+
+    mr_msh_printf("|%-*s|%-10s|%-10s|%-8s|\r\n", MR_CFG_DEV_NAME_LEN, "tag", "used", "peak", "count");
+    for (size_t i = 0; mr_heap_get_tag_stats(i, &stats) == MR_EOK; i++) {
+        mr_msh_printf("|%-*.*s|%-10u|%-10u|%-8u|\r\n",
+                      MR_CFG_DEV_NAME_LEN,
+                      MR_CFG_DEV_NAME_LEN,
+                      (stats.name != MR_NULL) ? stats.name : "-",
+                      (uint32_t)stats.used,
+                      (uint32_t)stats.peak,
+                      (uint32_t)stats.count);
+    }
+}
+
+#ifdef MR_USING_HEAP_SLAB
+static void msh_heap_print_slab(void)
+{
+    struct mr_heap_slab_stats stats;
+
+    mr_msh_printf("|%-6s|%-8s|%-8s|%-8s|%-8s|\r\n", "size", "total", "used", "peak", "fails");
+    for (size_t i = 0; mr_heap_slab_get_stats(i, &stats) == MR_EOK; i++) {
+        mr_msh_printf("|%-6u|%-8u|%-8u|%-8u|%-8u|\r\n",
+                      (uint32_t)stats.size,
+                      (uint32_t)stats.total,
+                      (uint32_t)stats.used,
+                      (uint32_t)stats.peak,
+                      (uint32_t)stats.fails);
+    }
+}
+#endif /* MR_USING_HEAP_SLAB */
+
+static void msh_cmd_heap(int argc, void *argv)
+{
+    struct mr_heap_stats stats;
+
+    if (argc < 1) {
+        mr_heap_get_stats(&stats);
+        mr_msh_printf("total:       %u\r\n", (uint32_t)stats.total);
+        mr_msh_printf("used:        %u\r\n", (uint32_t)stats.used);
+        mr_msh_printf("peak:        %u\r\n", (uint32_t)stats.peak);
+        mr_msh_printf("free:        %u\r\n", (uint32_t)stats.free);
+        mr_msh_printf("free blocks: %u\r\n", (uint32_t)stats.free_blocks);
+        mr_msh_printf("max free:    %u\r\n", (uint32_t)stats.max_free);
+        mr_msh_printf("frag:        %u%%\r\n", stats.frag);
+        mr_msh_printf("fails:       %u\r\n", (uint32_t)stats.fails);
+        return;
+    }
+
+    /* Parse <-t|-s> */
+    if (strncmp(MR_MSH_GET_ARG(1), "-t", 2) == 0) {
+        msh_heap_print_tags();
+#ifdef MR_USING_HEAP_SLAB
+    } else if (strncmp(MR_MSH_GET_ARG(1), "-s", 2) == 0) {
+        msh_heap_print_slab();
+#endif /* MR_USING_HEAP_SLAB */
+    } else {
+        goto usage;
+    }
+    return;
+
+    usage:
+#ifdef MR_USING_HEAP_SLAB
+    mr_msh_printf("usage: heap [-t|-s]\r\n");
+#else
+    mr_msh_printf("usage: heap [-t]\r\n");
+#endif /* MR_USING_HEAP_SLAB */
+}
+
+/**
+ * @brief Exports heap MSH commands.
+ */
+MR_MSH_CMD_EXPORT(heap, msh_cmd_heap, "show heap statistics.");
+
+#endif /* defined(MR_USING_MSH) && defined(MR_USING_HEAP_STATS) */
@@ -0,0 +1,68 @@
+/*
+ * @copyright (c) 2023-2024, MR Development Team
+ *
+ * @license SPDX-License-Identifier: Apache-2.0
+ *
+ * @date 2024-03-25    MacRsh       First version
+ */
+
+#include "include/components/mr_msh.h"
+
+#if defined(MR_USING_MSH) && defined(MR_USING_TRACE)
+
+void msh_trace_print_devs(void);
+
+static void msh_trace_dump(void)
+{
+    struct mr_trace_event event;
+    size_t i;
+
+    /* Stop tracing while dumping, the dump itself would overwrite the oldest events */
+    int enable = mr_trace_set_enable(MR_DISABLE);
+
+    msh_trace_print_devs();
+    for (i = 0; mr_trace_get_event(i, &event) == MR_EOK; i++) {
+        mr_msh_printf("E %u %08x %08x %08x %d %d\r\n",
+                      event.type,
+                      event.time,
+                      event.cycles,
+                      event.obj,
+                      (int)event.arg,
+                      (int)event.ret);
+    }
+    mr_msh_printf("trace: %u events\r\n", (uint32_t)i);
+    mr_trace_set_enable(enable);
+}
+
+static void msh_cmd_trace(int argc, void *argv)
+{
+    if (argc < 1) {
+        msh_trace_dump();
+        return;
+    }
+
+    /* Parse <-c|-e|-d> */
+    if (strncmp(MR_MSH_GET_ARG(1), "-c", 2) == 0) {
+        mr_trace_clear();
+    } else if (strncmp(MR_MSH_GET_ARG(1), "-e", 2) == 0) {
+        mr_trace_set_enable(MR_ENABLE);
+    } else if (strncmp(MR_MSH_GET_ARG(1), "-d", 2) == 0) {
+        mr_trace_set_enable(MR_DISABLE);
+    } else {
+        goto usage;
+    }
+    return;
+
+    usage:
+    mr_msh_printf("usage: trace [-c|-e|-d]\r\n");
+    mr_msh_printf("       []: dump the events, decode them with trace.py\r\n");
+    mr_msh_printf("       [-c]: clear the events\r\n");
+    mr_msh_printf("       [-e|-d]: enable or disable the trace\r\n");
+}
+
+/**
+ * @brief Exports trace MSH commands.
+ */
+MR_MSH_CMD_EXPORT(trace, msh_cmd_trace, "dump the trace events.");
+
+#endif /* defined(MR_USING_MSH) && defined(MR_USING_TRACE) */
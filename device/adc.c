@@ -148,6 +148,8 @@ int mr_adc_register(struct mr_adc *adc, const char *path, struct mr_drv *drv)
                                     mr_adc_read,
                                     MR_NULL,
                                     mr_adc_ioctl,
+                                    MR_NULL,
+                                    MR_NULL,
                                     MR_NULL};
 
     MR_ASSERT(adc != MR_NULL);
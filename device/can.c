@@ -65,7 +65,8 @@ static ssize_t mr_can_bus_isr(struct mr_dev *dev, int event, void *args)
 
                 /* Check id is valid */
                 if (can_dev->id == id) {
-                    mr_ringbuf_write_force(&can_dev->rd_fifo, data, ret);
+                    /* Keep the frame as one record, the oldest frames are discarded on overflow */
+                    mr_ringbuf_write_record_force(&can_dev->rd_fifo, data, ret);
 
                     return mr_dev_isr(&can_dev->dev, event, &rtr);
                 }
@@ -94,7 +95,9 @@ int mr_can_bus_register(struct mr_can_bus *can_bus, const char *path, struct mr_
                                     mr_can_bus_read,
                                     mr_can_bus_write,
                                     MR_NULL,
-                                    mr_can_bus_isr};
+                                    mr_can_bus_isr,
+                                    MR_NULL,
+                                    MR_NULL};
     struct mr_can_config default_config = MR_CAN_CONFIG_DEFAULT;
 
     MR_ASSERT(can_bus != MR_NULL);
@@ -123,22 +126,32 @@ MR_INLINE int can_dev_take_bus(struct mr_can_dev *can_dev)
     struct mr_can_bus *can_bus = (struct mr_can_bus *)can_dev->dev.parent;
     struct mr_can_bus_ops *ops = (struct mr_can_bus_ops *)can_bus->dev.drv->ops;
 
+    /* Check if the bus is busy and hold it at once, the siblings on other threads see it busy */
+    mr_interrupt_disable();
     if ((can_bus->hold == MR_TRUE) && (can_dev != can_bus->owner)) {
+        mr_interrupt_enable();
         return MR_EBUSY;
     }
+    int owner_changed = (can_dev != can_bus->owner);
+    can_bus->owner = can_dev;
+    can_bus->hold = MR_TRUE;
+    mr_interrupt_enable();
 
     /* If the owner changes, recheck the configuration */
-    if (can_dev != can_bus->owner) {
+    if (owner_changed == MR_TRUE) {
         if (can_dev->config.baud_rate != can_bus->config.baud_rate) {
             int ret = ops->configure(can_bus, &can_dev->config);
             if (ret < 0) {
+                /* Give up the bus, the next owner rechecks the configuration */
+                mr_interrupt_disable();
+                can_bus->owner = MR_NULL;
+                can_bus->hold = MR_FALSE;
+                mr_interrupt_enable();
                 return ret;
             }
         }
         can_bus->config = can_dev->config;
-        can_bus->owner = can_dev;
     }
-    can_bus->hold = MR_TRUE;
     return MR_EOK;
 }
 
@@ -146,11 +159,14 @@ MR_INLINE int can_dev_release_bus(struct mr_can_dev *can_dev)
 {
     struct mr_can_bus *can_bus = (struct mr_can_bus *)can_dev->dev.parent;
 
+    mr_interrupt_disable();
     if (can_dev != can_bus->owner) {
+        mr_interrupt_enable();
         return MR_EINVAL;
     }
 
     can_bus->hold = MR_FALSE;
+    mr_interrupt_enable();
     return MR_EOK;
 }
 
@@ -204,7 +220,7 @@ static ssize_t mr_can_dev_read(struct mr_dev *dev, void *buf, size_t count)
         return ret;
     }
 
-    ret = (ssize_t)mr_ringbuf_read(&can_dev->rd_fifo, buf, count);
+    ret = (ssize_t)mr_ringbuf_read_record(&can_dev->rd_fifo, buf, count);
 
     can_dev_release_bus(can_dev);
     return ret;
@@ -236,10 +252,12 @@ static int mr_can_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
                 struct mr_can_config config = *(struct mr_can_config *)args;
 
                 /* If holding the bus, release it */
+                mr_interrupt_disable();
                 if (can_dev == can_bus->owner) {
                     can_bus->hold = MR_FALSE;
                     can_bus->owner = MR_NULL;
                 }
+                mr_interrupt_enable();
                 can_dev->config = config;
                 return sizeof(config);
             }
@@ -254,7 +272,7 @@ static int mr_can_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
                 if (ret < 0) {
                     return ret;
                 }
-                can_dev->rd_bufsz = bufsz;
+                can_dev->rd_bufsz = mr_ringbuf_get_bufsz(&can_dev->rd_fifo);
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
@@ -279,7 +297,7 @@ static int mr_can_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *bufsz = (size_t *)args;
 
-                *bufsz = can_dev->rd_bufsz;
+                *bufsz = mr_ringbuf_get_bufsz(&can_dev->rd_fifo);
                 return sizeof(*bufsz);
             }
             return MR_EINVAL;
@@ -288,7 +306,7 @@ static int mr_can_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *datasz = (size_t *)args;
 
-                *datasz = mr_ringbuf_get_data_size(&can_dev->rd_fifo);
+                *datasz = mr_ringbuf_get_record_size(&can_dev->rd_fifo);
                 return sizeof(*datasz);
             }
             return MR_EINVAL;
@@ -316,6 +334,8 @@ int mr_can_dev_register(struct mr_can_dev *can_dev, const char *path, int id, in
                                     mr_can_dev_read,
                                     mr_can_dev_write,
                                     mr_can_dev_ioctl,
+                                    MR_NULL,
+                                    MR_NULL,
                                     MR_NULL};
     struct mr_can_config default_config = MR_CAN_CONFIG_DEFAULT;
 
@@ -148,6 +148,8 @@ int mr_dac_register(struct mr_dac *dac, const char *path, struct mr_drv *drv)
                                     MR_NULL,
                                     mr_dac_write,
                                     mr_dac_ioctl,
+                                    MR_NULL,
+                                    MR_NULL,
                                     MR_NULL};
 
     MR_ASSERT(dac != MR_NULL);
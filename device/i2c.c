@@ -83,7 +83,9 @@ int mr_i2c_bus_register(struct mr_i2c_bus *i2c_bus, const char *path, struct mr_
                                     mr_i2c_bus_read,
                                     mr_i2c_bus_write,
                                     MR_NULL,
-                                    mr_i2c_bus_isr};
+                                    mr_i2c_bus_isr,
+                                    MR_NULL,
+                                    MR_NULL};
     struct mr_i2c_config default_config = MR_I2C_CONFIG_DEFAULT;
 
     MR_ASSERT(i2c_bus != MR_NULL);
@@ -105,26 +107,35 @@ MR_INLINE int i2c_dev_take_bus(struct mr_i2c_dev *i2c_dev)
     struct mr_i2c_bus *i2c_bus = (struct mr_i2c_bus *)i2c_dev->dev.parent;
     struct mr_i2c_bus_ops *ops = (struct mr_i2c_bus_ops *)i2c_bus->dev.drv->ops;
 
-    /* Check if the bus is busy */
+    /* Check if the bus is busy and hold it at once, the siblings on other threads see it busy */
+    mr_interrupt_disable();
     if ((i2c_bus->hold == MR_TRUE) && (i2c_dev != i2c_bus->owner)) {
+        mr_interrupt_enable();
         return MR_EBUSY;
     }
+    int owner_changed = (i2c_dev != i2c_bus->owner);
+    i2c_bus->owner = i2c_dev;
+    i2c_bus->hold = MR_TRUE;
+    mr_interrupt_enable();
 
     /* If the owner changes, recheck the configuration */
-    if (i2c_dev != i2c_bus->owner) {
+    if (owner_changed == MR_TRUE) {
         if (i2c_dev->config.baud_rate != i2c_bus->config.baud_rate ||
             i2c_dev->config.host_slave != i2c_bus->config.host_slave) {
             int addr = (i2c_dev->config.host_slave == MR_I2C_HOST) ? 0x00 : i2c_dev->addr;
 
             int ret = ops->configure(i2c_bus, &i2c_dev->config, addr, i2c_dev->addr_bits);
             if (ret < 0) {
+                /* Give up the bus, the next owner rechecks the configuration */
+                mr_interrupt_disable();
+                i2c_bus->owner = MR_NULL;
+                i2c_bus->hold = MR_FALSE;
+                mr_interrupt_enable();
                 return ret;
             }
         }
         i2c_bus->config = i2c_dev->config;
-        i2c_bus->owner = i2c_dev;
     }
-    i2c_bus->hold = MR_TRUE;
     return MR_EOK;
 }
 
@@ -132,7 +143,9 @@ MR_INLINE int i2c_dev_release_bus(struct mr_i2c_dev *i2c_dev)
 {
     struct mr_i2c_bus *i2c_bus = (struct mr_i2c_bus *)i2c_dev->dev.parent;
 
+    mr_interrupt_disable();
     if (i2c_dev != i2c_bus->owner) {
+        mr_interrupt_enable();
         return MR_EINVAL;
     }
 
@@ -140,6 +153,7 @@ MR_INLINE int i2c_dev_release_bus(struct mr_i2c_dev *i2c_dev)
     if (i2c_dev->config.host_slave == MR_I2C_HOST) {
         i2c_bus->hold = MR_FALSE;
     }
+    mr_interrupt_enable();
     return MR_EOK;
 }
 
@@ -178,14 +192,14 @@ MR_INLINE void i2c_dev_send_stop(struct mr_i2c_dev *i2c_dev)
     ops->stop(i2c_bus);
 }
 
-MR_INLINE ssize_t i2c_dev_read(struct mr_i2c_dev *i2c_dev, uint8_t *buf, size_t count)
+MR_INLINE ssize_t i2c_dev_read(struct mr_i2c_dev *i2c_dev, uint8_t *buf, size_t count, int last)
 {
     struct mr_i2c_bus *i2c_bus = (struct mr_i2c_bus *)i2c_dev->dev.parent;
     struct mr_i2c_bus_ops *ops = (struct mr_i2c_bus_ops *)i2c_bus->dev.drv->ops;
     ssize_t rd_size;
 
     for (rd_size = 0; rd_size < count; rd_size += sizeof(*buf)) {
-        int ack = ((count - rd_size) != sizeof(*buf));
+        int ack = ((last == MR_FALSE) || ((count - rd_size) != sizeof(*buf)));
 
         int ret = ops->read(i2c_bus, buf, ack);
         if (ret < 0) {
@@ -227,9 +241,10 @@ static int mr_i2c_dev_close(struct mr_dev *dev)
     return MR_EOK;
 }
 
-static ssize_t mr_i2c_dev_read(struct mr_dev *dev, void *buf, size_t count)
+static ssize_t mr_i2c_dev_readv(struct mr_dev *dev, const struct mr_dev_iovec *iov, size_t iovcnt)
 {
     struct mr_i2c_dev *i2c_dev = (struct mr_i2c_dev *)dev;
+    size_t last = 0;
 
     ssize_t ret = i2c_dev_take_bus(i2c_dev);
     if (ret < 0) {
@@ -256,10 +271,35 @@ static ssize_t mr_i2c_dev_read(struct mr_dev *dev, void *buf, size_t count)
         if (ret < 0) {
             goto release_bus;
         }
-        ret = i2c_dev_read(i2c_dev, (uint8_t *)buf, count);
+
+        /* Read all buffers in one transfer, only the last byte of the last buffer is not acknowledged */
+        for (size_t i = 0; i < iovcnt; i++) {
+            if (iov[i].count != 0) {
+                last = i;
+            }
+        }
+        ret = 0;
+        for (size_t i = 0; i <= last; i++) {
+            ssize_t size = i2c_dev_read(i2c_dev, (uint8_t *)iov[i].buf, iov[i].count, (i == last));
+            if (size < 0) {
+                ret = (ret == 0) ? size : ret;
+                break;
+            }
+            ret += size;
+            if ((size_t)size < iov[i].count) {
+                break;
+            }
+        }
         i2c_dev_send_stop(i2c_dev);
     } else {
-        ret = (ssize_t)mr_ringbuf_read(&i2c_dev->rd_fifo, buf, count);
+        ret = 0;
+        for (size_t i = 0; i < iovcnt; i++) {
+            size_t size = mr_ringbuf_read(&i2c_dev->rd_fifo, iov[i].buf, iov[i].count);
+            ret += (ssize_t)size;
+            if (size < iov[i].count) {
+                break;
+            }
+        }
     }
 
     release_bus:
@@ -267,7 +307,7 @@ static ssize_t mr_i2c_dev_read(struct mr_dev *dev, void *buf, size_t count)
     return ret;
 }
 
-static ssize_t mr_i2c_dev_write(struct mr_dev *dev, const void *buf, size_t count)
+static ssize_t mr_i2c_dev_writev(struct mr_dev *dev, const struct mr_dev_iovec *iov, size_t iovcnt)
 {
     struct mr_i2c_dev *i2c_dev = (struct mr_i2c_dev *)dev;
 
@@ -291,11 +331,23 @@ static ssize_t mr_i2c_dev_write(struct mr_dev *dev, const void *buf, size_t coun
                 goto release_bus;
             }
         }
+    }
 
-        ret = i2c_dev_write(i2c_dev, (uint8_t *)buf, count);
+    /* Write all buffers in one transfer */
+    ret = 0;
+    for (size_t i = 0; i < iovcnt; i++) {
+        ssize_t size = i2c_dev_write(i2c_dev, (const uint8_t *)iov[i].buf, iov[i].count);
+        if (size < 0) {
+            ret = (ret == 0) ? size : ret;
+            break;
+        }
+        ret += size;
+        if ((size_t)size < iov[i].count) {
+            break;
+        }
+    }
+    if (i2c_dev->config.host_slave == MR_I2C_HOST) {
         i2c_dev_send_stop(i2c_dev);
-    } else {
-        ret = i2c_dev_write(i2c_dev, (uint8_t *)buf, count);
     }
 
     release_bus:
@@ -303,6 +355,20 @@ static ssize_t mr_i2c_dev_write(struct mr_dev *dev, const void *buf, size_t coun
     return ret;
 }
 
+static ssize_t mr_i2c_dev_read(struct mr_dev *dev, void *buf, size_t count)
+{
+    struct mr_dev_iovec iov = {buf, count};
+
+    return mr_i2c_dev_readv(dev, &iov, 1);
+}
+
+static ssize_t mr_i2c_dev_write(struct mr_dev *dev, const void *buf, size_t count)
+{
+    struct mr_dev_iovec iov = {(void *)buf, count};
+
+    return mr_i2c_dev_writev(dev, &iov, 1);
+}
+
 static int mr_i2c_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
 {
     struct mr_i2c_dev *i2c_dev = (struct mr_i2c_dev *)dev;
@@ -314,10 +380,12 @@ static int mr_i2c_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
                 struct mr_i2c_config config = *(struct mr_i2c_config *)args;
 
                 /* If holding the bus, release it */
+                mr_interrupt_disable();
                 if (i2c_dev == i2c_bus->owner) {
                     i2c_bus->hold = MR_FALSE;
                     i2c_bus->owner = MR_NULL;
                 }
+                mr_interrupt_enable();
 
                 /* Update the configuration and try again to get the bus */
                 i2c_dev->config = config;
@@ -340,7 +408,7 @@ static int mr_i2c_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
                 if (ret < 0) {
                     return ret;
                 }
-                i2c_dev->rd_bufsz = bufsz;
+                i2c_dev->rd_bufsz = mr_ringbuf_get_bufsz(&i2c_dev->rd_fifo);
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
@@ -362,7 +430,7 @@ static int mr_i2c_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *bufsz = (size_t *)args;
 
-                *bufsz = i2c_dev->rd_bufsz;
+                *bufsz = mr_ringbuf_get_bufsz(&i2c_dev->rd_fifo);
                 return sizeof(*bufsz);
             }
             return MR_EINVAL;
@@ -371,7 +439,7 @@ static int mr_i2c_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *datasz = (size_t *)args;
 
-                *datasz = mr_ringbuf_get_bufsz(&i2c_dev->rd_fifo);
+                *datasz = mr_ringbuf_get_data_size(&i2c_dev->rd_fifo);
                 return sizeof(*datasz);
             }
             return MR_EINVAL;
@@ -399,7 +467,9 @@ int mr_i2c_dev_register(struct mr_i2c_dev *i2c_dev, const char *path, int addr,
                                     mr_i2c_dev_read,
                                     mr_i2c_dev_write,
                                     mr_i2c_dev_ioctl,
-                                    MR_NULL};
+                                    MR_NULL,
+                                    mr_i2c_dev_readv,
+                                    mr_i2c_dev_writev};
     struct mr_i2c_config default_config = MR_I2C_CONFIG_DEFAULT;
 
     MR_ASSERT(i2c_dev != MR_NULL);
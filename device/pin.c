@@ -10,8 +10,6 @@
 
 #ifdef MR_USING_PIN
 
-void _mr_fast_pin_init(struct mr_dev *dev);
-
 #define PIN_MODE_SET(_pin, _number, _mode)                                              \
     do                                                                                  \
     {                                                                                   \
@@ -182,7 +180,9 @@ int mr_pin_register(struct mr_pin *pin, const char *path, struct mr_drv *drv)
                                     mr_pin_read,
                                     mr_pin_write,
                                     mr_pin_ioctl,
-                                    mr_pin_isr};
+                                    mr_pin_isr,
+                                    MR_NULL,
+                                    MR_NULL};
 
     MR_ASSERT(pin != MR_NULL);
     MR_ASSERT(path != MR_NULL);
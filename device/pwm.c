@@ -285,6 +285,8 @@ int mr_pwm_register(struct mr_pwm *pwm,
                                     mr_pwm_read,
                                     mr_pwm_write,
                                     mr_pwm_ioctl,
+                                    MR_NULL,
+                                    MR_NULL,
                                     MR_NULL};
 
     MR_ASSERT(pwm != MR_NULL);
@@ -10,6 +10,135 @@
 
 #ifdef MR_USING_SERIAL
 
+#ifdef MR_USING_SERIAL_DMA
+#ifndef MR_CFG_SERIAL_DMA_ALIGN
+#define MR_CFG_SERIAL_DMA_ALIGN         (32)
+#endif /* MR_CFG_SERIAL_DMA_ALIGN */
+#ifdef MR_USING_SERIAL_DMA_TXQ
+#ifndef MR_CFG_SERIAL_DMA_TXQ_COPY
+#define MR_CFG_SERIAL_DMA_TXQ_COPY      (32)
+#endif /* MR_CFG_SERIAL_DMA_TXQ_COPY */
+#endif /* MR_USING_SERIAL_DMA_TXQ */
+#endif /* MR_USING_SERIAL_DMA */
+
+#ifdef MR_USING_SERIAL_RS485
+#include "include/device/mr_pin.h"
+
+#ifndef MR_CFG_SERIAL_RS485_DELAY_MAX
+#define MR_CFG_SERIAL_RS485_DELAY_MAX   (100)
+#endif /* MR_CFG_SERIAL_RS485_DELAY_MAX */
+#ifndef MR_CFG_SERIAL_RS485_TIMEOUT
+#define MR_CFG_SERIAL_RS485_TIMEOUT     (4)
+#endif /* MR_CFG_SERIAL_RS485_TIMEOUT */
+
+#define SERIAL_RS485_IDLE               (0)                         /* DE released */
+#define SERIAL_RS485_NONBLOCK           (1)                         /* DE asserted by the nonblocking write */
+#define SERIAL_RS485_POLL               (2)                         /* DE asserted by the polling write */
+
+MR_INLINE void serial_rs485_begin(struct mr_serial *serial)
+{
+    /* The nonblocking state is set first, so the transmit-complete of the last transfer can not release it */
+    if ((serial->rs485.pin >= 0) && (serial->rs485_state == SERIAL_RS485_IDLE)) {
+        serial->rs485_state = SERIAL_RS485_NONBLOCK;
+        _mr_fast_pin_write(serial->rs485.pin, serial->rs485.level);
+        mr_delay_us(serial->rs485.pre_delay);
+    }
+}
+
+MR_INLINE void serial_rs485_end(struct mr_serial *serial)
+{
+    if ((serial->rs485.pin >= 0) && (serial->rs485_state != SERIAL_RS485_IDLE)) {
+        mr_delay_us(serial->rs485.post_delay);
+        _mr_fast_pin_write(serial->rs485.pin, !serial->rs485.level);
+        serial->rs485_state = SERIAL_RS485_IDLE;
+    }
+}
+
+static void serial_rs485_poll_begin(struct mr_serial *serial)
+{
+    if (serial->rs485.pin < 0) {
+        return;
+    }
+
+    /* Take over the DE, the transmit-complete of the last nonblocking transfer may be still pending */
+    mr_interrupt_disable();
+    int state = serial->rs485_state;
+    serial->rs485_state = SERIAL_RS485_POLL;
+    if (state == SERIAL_RS485_IDLE) {
+        _mr_fast_pin_write(serial->rs485.pin, serial->rs485.level);
+    }
+    mr_interrupt_enable();
+    if (state == SERIAL_RS485_IDLE) {
+        mr_delay_us(serial->rs485.pre_delay);
+    }
+}
+
+static uint32_t serial_rs485_char_time(struct mr_serial *serial)
+{
+    uint32_t bits = 1 + serial->config.data_bits + serial->config.stop_bits +
+                    ((serial->config.parity != MR_SERIAL_PARITY_NONE) ? 1 : 0);
+
+    /* Character time in us, one millisecond if the baud rate is not set */
+    if (serial->config.baud_rate == 0) {
+        return 1000;
+    }
+    return (bits * 1000000 + serial->config.baud_rate - 1) / serial->config.baud_rate;
+}
+
+static int serial_rs485_poll_end(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+    int ret = MR_EOK;
+
+    if (serial->rs485.pin < 0) {
+        return MR_EOK;
+    }
+
+    /* Wait for the last bit for a few character times, without the driver support wait for one character time */
+    if (ops->is_tx_complete != MR_NULL) {
+        uint32_t timeout = serial_rs485_char_time(serial) * MR_CFG_SERIAL_RS485_TIMEOUT;
+
+        while (ops->is_tx_complete(serial) == MR_FALSE) {
+            if (timeout-- == 0) {
+                ret = MR_ETIMEOUT;
+                break;
+            }
+            mr_delay_us(1);
+        }
+    } else {
+        mr_delay_us(serial_rs485_char_time(serial));
+    }
+
+    /* Release the DE even on timeout, so the bus is not held */
+    serial_rs485_end(serial);
+    return ret;
+}
+
+static int serial_rs485_configure(struct mr_serial *serial, struct mr_serial_rs485_config *config)
+{
+    if ((serial->nonblock_state == MR_ENABLE) || (serial->rs485_state != SERIAL_RS485_IDLE)) {
+        return MR_EBUSY;
+    }
+
+    /* The post-delay is waited in the transmit-complete interrupt */
+    if ((config->pre_delay > MR_CFG_SERIAL_RS485_DELAY_MAX) || (config->post_delay > MR_CFG_SERIAL_RS485_DELAY_MAX)) {
+        return MR_EINVAL;
+    }
+
+    /* Configure the DE pin released */
+    config->level = (config->level != 0) ? 1 : 0;
+    if (config->pin >= 0) {
+        int ret = _mr_fast_pin_mode(config->pin, MR_PIN_MODE_OUTPUT);
+        if (ret < 0) {
+            return ret;
+        }
+        _mr_fast_pin_write(config->pin, !config->level);
+    }
+    serial->rs485 = *config;
+    return MR_EOK;
+}
+#endif /* MR_USING_SERIAL_RS485 */
+
 MR_INLINE ssize_t serial_poll_read(struct mr_serial *serial, uint8_t *buf, size_t count)
 {
     struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
@@ -47,6 +176,10 @@ MR_INLINE ssize_t serial_dma_write(struct mr_serial *serial, uint8_t *buf, size_
 
     if (serial->dma_wr_bufsz == 0) {
         if (serial->nonblock_state == MR_DISABLE) {
+            serial->nonblock_state = MR_ENABLE;
+#ifdef MR_USING_SERIAL_RS485
+            serial_rs485_begin(serial);
+#endif /* MR_USING_SERIAL_RS485 */
             ops->start_dma_tx(serial, buf, count);
             return (ssize_t)count;
         } else {
@@ -54,6 +187,10 @@ MR_INLINE ssize_t serial_dma_write(struct mr_serial *serial, uint8_t *buf, size_
         }
     } else {
         if (serial->nonblock_state == MR_DISABLE) {
+            serial->nonblock_state = MR_ENABLE;
+#ifdef MR_USING_SERIAL_RS485
+            serial_rs485_begin(serial);
+#endif /* MR_USING_SERIAL_RS485 */
             if (count > serial->dma_wr_bufsz) {
                 memcpy(serial->dma_wr_buf, buf, serial->dma_wr_bufsz);
                 ops->start_dma_tx(serial, serial->dma_wr_buf, serial->dma_wr_bufsz);
@@ -71,6 +208,265 @@ MR_INLINE ssize_t serial_dma_write(struct mr_serial *serial, uint8_t *buf, size_
         }
     }
 }
+
+MR_INLINE void serial_dma_rx_start(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+
+    if (serial->dma_rd_bufsz == 0) {
+        return;
+    }
+
+#ifdef MR_USING_SERIAL_DMA_CIRC
+    /* Circular receiving, the DMA buffer is the read FIFO and is never stopped */
+    if (ops->start_dma_rx_circ != MR_NULL) {
+        serial->dma_rd_wpos = 0;
+        serial->dma_rd_rpos = 0;
+        serial->dma_rd_in = 0;
+        serial->dma_rd_out = 0;
+        serial->dma_rd_circ = MR_ENABLE;
+        ops->start_dma_rx_circ(serial, serial->dma_rd_buf, serial->dma_rd_bufsz);
+        return;
+    }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+
+    if (ops->start_dma_rx != MR_NULL) {
+        ops->start_dma_rx(serial, serial->dma_rd_buf, serial->dma_rd_bufsz);
+    }
+}
+
+MR_INLINE void serial_dma_rx_stop(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+
+#ifdef MR_USING_SERIAL_DMA_CIRC
+    serial->dma_rd_circ = MR_DISABLE;
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+    if ((ops->stop_dma_rx != MR_NULL) && (serial->dma_rd_bufsz != 0)) {
+        ops->stop_dma_rx(serial);
+    }
+}
+
+#ifdef MR_USING_SERIAL_DMA_CIRC
+MR_INLINE size_t serial_dma_circ_get_data_size(struct mr_serial *serial)
+{
+    size_t size = serial->dma_rd_in - serial->dma_rd_out;
+
+    return MR_MIN(size, serial->dma_rd_bufsz);
+}
+
+MR_INLINE ssize_t serial_dma_circ_read(struct mr_serial *serial, uint8_t *buf, size_t count)
+{
+    size_t bufsz = serial->dma_rd_bufsz;
+    size_t size = serial->dma_rd_in - serial->dma_rd_out;
+
+    /* The DMA has overrun the reader, skip to the oldest data still in the buffer */
+    if (size > bufsz) {
+        serial->dma_rd_lost += size - bufsz;
+        serial->dma_rd_out += size - bufsz;
+        serial->dma_rd_rpos = (serial->dma_rd_rpos + (size - bufsz) % bufsz) % bufsz;
+        size = bufsz;
+    }
+
+    /* Copy straight out of the DMA buffer, in two parts when it wraps around */
+    count = MR_MIN(count, size);
+    size = MR_MIN(count, bufsz - serial->dma_rd_rpos);
+    memcpy(buf, &serial->dma_rd_buf[serial->dma_rd_rpos], size);
+    memcpy(buf + size, serial->dma_rd_buf, count - size);
+    serial->dma_rd_rpos = (serial->dma_rd_rpos + count) % bufsz;
+    serial->dma_rd_out += count;
+    return (ssize_t)count;
+}
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+
+#ifdef MR_USING_SERIAL_DMA_TXQ
+MR_INLINE void serial_txq_init(struct mr_serial *serial)
+{
+    /* The write DMA buffer is split into two staging buffers, one is filled while the other is transmitted */
+    size_t stagesz = serial->dma_wr_bufsz / 2;
+
+    for (size_t i = 0; i < MR_ARRAY_NUM(serial->tx_stage); i++) {
+        mr_list_init(&serial->tx_stage[i].list);
+        serial->tx_stage[i].buf = (serial->dma_wr_buf != MR_NULL) ? (serial->dma_wr_buf + i * stagesz) : MR_NULL;
+        serial->tx_stage[i].count = 0;
+    }
+}
+
+MR_INLINE int serial_txq_is_stage(struct mr_serial *serial, struct mr_serial_tx *tx)
+{
+    return (tx >= &serial->tx_stage[0]) && (tx < &serial->tx_stage[MR_ARRAY_NUM(serial->tx_stage)]);
+}
+
+static ssize_t serial_txq_start(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+
+    /* Transmit the first request, stop when there are none */
+    if (mr_list_is_empty(&serial->tx_list) == MR_TRUE) {
+        serial->nonblock_state = MR_DISABLE;
+        ops->stop_dma_tx(serial);
+        return MR_EOK;
+    }
+    struct mr_serial_tx *tx = MR_CONTAINER_OF(serial->tx_list.next, struct mr_serial_tx, list);
+    serial->nonblock_state = MR_ENABLE;
+#ifdef MR_USING_SERIAL_RS485
+    serial_rs485_begin(serial);
+#endif /* MR_USING_SERIAL_RS485 */
+    ops->start_dma_tx(serial, (uint8_t *)tx->buf, tx->count);
+    return MR_EBUSY;
+}
+
+static struct mr_serial_tx *serial_txq_get_stage(struct mr_serial *serial)
+{
+    size_t stagesz = serial->dma_wr_bufsz / 2;
+
+    /* Append to the last request when it is a staging buffer that is not in flight and not full */
+    if (mr_list_is_empty(&serial->tx_list) == MR_FALSE) {
+        struct mr_serial_tx *tx = MR_CONTAINER_OF(serial->tx_list.prev, struct mr_serial_tx, list);
+
+        if ((serial_txq_is_stage(serial, tx) == MR_TRUE) &&
+            (serial->tx_list.prev != serial->tx_list.next) &&
+            (tx->count < stagesz)) {
+            return tx;
+        }
+    }
+
+    /* Queue a free staging buffer */
+    for (size_t i = 0; i < MR_ARRAY_NUM(serial->tx_stage); i++) {
+        struct mr_serial_tx *tx = &serial->tx_stage[i];
+
+        if (mr_list_is_empty(&tx->list) == MR_TRUE) {
+            tx->count = 0;
+            mr_list_insert_before(&serial->tx_list, &tx->list);
+            return tx;
+        }
+    }
+    return MR_NULL;
+}
+
+static ssize_t serial_txq_write(struct mr_serial *serial, const uint8_t *buf, size_t count, int all)
+{
+    size_t stagesz = serial->dma_wr_bufsz / 2;
+    size_t size = 0;
+
+    if (stagesz == 0) {
+        /* A queued request is transmitted in place */
+        if (all == MR_TRUE) {
+            return 0;
+        }
+
+        /* Without the staging buffers, transmit straight from the buffer of the caller when the queue is idle */
+        mr_interrupt_disable();
+        if (mr_list_is_empty(&serial->tx_list) == MR_FALSE) {
+            mr_interrupt_enable();
+            return MR_EBUSY;
+        }
+        serial->tx_stage[0].buf = buf;
+        serial->tx_stage[0].count = count;
+        mr_list_insert_before(&serial->tx_list, &serial->tx_stage[0].list);
+        serial_txq_start(serial);
+        mr_interrupt_enable();
+        return (ssize_t)count;
+    }
+
+    mr_interrupt_disable();
+
+    /* Check the free space of the staging buffers when it must be written entirely */
+    if (all == MR_TRUE) {
+        size_t free = 0;
+
+        for (size_t i = 0; i < MR_ARRAY_NUM(serial->tx_stage); i++) {
+            struct mr_serial_tx *tx = &serial->tx_stage[i];
+
+            if (mr_list_is_empty(&tx->list) == MR_TRUE) {
+                free += stagesz;
+            } else if ((&tx->list == serial->tx_list.prev) && (serial->tx_list.prev != serial->tx_list.next)) {
+                free += stagesz - tx->count;
+            }
+        }
+        if (free < count) {
+            mr_interrupt_enable();
+            return 0;
+        }
+    }
+
+    /* Coalesce into the staging buffers */
+    while (size < count) {
+        struct mr_serial_tx *tx = serial_txq_get_stage(serial);
+        if (tx == MR_NULL) {
+            break;
+        }
+
+        size_t n = MR_MIN(count - size, stagesz - tx->count);
+        memcpy((uint8_t *)tx->buf + tx->count, buf + size, n);
+        tx->count += n;
+        size += n;
+    }
+    if ((size > 0) && (serial->nonblock_state == MR_DISABLE)) {
+        serial_txq_start(serial);
+    }
+
+    mr_interrupt_enable();
+    return (ssize_t)size;
+}
+
+static void serial_txq_clear(struct mr_serial *serial)
+{
+    mr_interrupt_disable();
+
+    /* Drop the requests that are not transmitted, the one in flight still owns the DMA */
+    for (struct mr_list *list = serial->tx_list.next; list != &serial->tx_list;) {
+        struct mr_serial_tx *tx = MR_CONTAINER_OF(list, struct mr_serial_tx, list);
+
+        list = list->next;
+        if ((serial->nonblock_state == MR_ENABLE) && (&tx->list == serial->tx_list.next)) {
+            continue;
+        }
+        mr_list_remove(&tx->list);
+        if (serial_txq_is_stage(serial, tx) == MR_TRUE) {
+            tx->count = 0;
+        } else if (tx->done != MR_NULL) {
+            tx->ret = MR_EIO;
+            tx->done(tx);
+        }
+    }
+
+    mr_interrupt_enable();
+}
+
+MR_INLINE size_t serial_txq_get_data_size(struct mr_serial *serial)
+{
+    size_t size = 0;
+
+    mr_interrupt_disable();
+    for (struct mr_list *list = serial->tx_list.next; list != &serial->tx_list; list = list->next) {
+        size += MR_CONTAINER_OF(list, struct mr_serial_tx, list)->count;
+    }
+    mr_interrupt_enable();
+    return size;
+}
+
+static void serial_txq_abort(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+
+    if (serial->nonblock_state == MR_ENABLE) {
+        serial->nonblock_state = MR_DISABLE;
+        ops->stop_dma_tx(serial);
+    }
+
+    /* Complete the requests that are not transmitted */
+    while (mr_list_is_empty(&serial->tx_list) == MR_FALSE) {
+        struct mr_serial_tx *tx = MR_CONTAINER_OF(serial->tx_list.next, struct mr_serial_tx, list);
+
+        mr_list_remove(&tx->list);
+        if ((serial_txq_is_stage(serial, tx) == MR_FALSE) && (tx->done != MR_NULL)) {
+            tx->ret = MR_EIO;
+            tx->done(tx);
+        }
+    }
+}
+#endif /* MR_USING_SERIAL_DMA_TXQ */
 #endif /* MR_USING_SERIAL_DMA */
 
 MR_INLINE ssize_t serial_nonblocking_write(struct mr_serial *serial, uint8_t *buf, size_t count)
@@ -81,18 +477,321 @@ MR_INLINE ssize_t serial_nonblocking_write(struct mr_serial *serial, uint8_t *bu
 #ifdef MR_USING_SERIAL_DMA
     /* DMA sending */
     if ((ops->start_dma_tx != MR_NULL) && (ops->stop_dma_tx != MR_NULL)) {
+#ifdef MR_USING_SERIAL_DMA_TXQ
+        return serial_txq_write(serial, buf, count, MR_FALSE);
+#else
         return serial_dma_write(serial, buf, count);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
     }
 #endif /* MR_USING_SERIAL_DMA */
 
     /* Interrupt sending */
     size = (ssize_t)mr_ringbuf_write(&serial->wr_fifo, buf, count);
     if ((size > 0) && (serial->nonblock_state == MR_DISABLE)) {
+        serial->nonblock_state = MR_ENABLE;
+#ifdef MR_USING_SERIAL_RS485
+        serial_rs485_begin(serial);
+#endif /* MR_USING_SERIAL_RS485 */
         ops->start_tx(serial);
     }
     return size;
 }
 
+#ifdef MR_USING_SERIAL_FRAME
+#define SERIAL_FRAME_SLIP_END           (0xc0)
+#define SERIAL_FRAME_SLIP_ESC           (0xdb)
+#define SERIAL_FRAME_SLIP_ESC_END       (0xdc)
+#define SERIAL_FRAME_SLIP_ESC_ESC       (0xdd)
+#define SERIAL_FRAME_WORD_ONES          ((size_t)-1 / 0xff)
+#define SERIAL_FRAME_WORD_HIGHS         (SERIAL_FRAME_WORD_ONES * 0x80)
+
+MR_INLINE int serial_frame_is_used(struct mr_serial *serial)
+{
+    return serial->frame.mode != MR_SERIAL_FRAME_NONE;
+}
+
+MR_INLINE void serial_frame_reset(struct mr_serial *serial)
+{
+    serial->frame_num = 0;
+    serial->frame_pos = 0;
+    serial->frame_scan = 0;
+}
+
+MR_INLINE int serial_frame_get_delim(struct mr_serial *serial)
+{
+    switch (serial->frame.mode) {
+        case MR_SERIAL_FRAME_LINE: {
+            return '\n';
+        }
+        case MR_SERIAL_FRAME_SLIP: {
+            return SERIAL_FRAME_SLIP_END;
+        }
+        case MR_SERIAL_FRAME_COBS: {
+            return 0x00;
+        }
+        default: {
+            return -1;
+        }
+    }
+}
+
+static size_t serial_frame_find(const uint8_t *buf, size_t size, uint8_t delim)
+{
+    size_t pattern = SERIAL_FRAME_WORD_ONES * delim;
+    size_t i = 0;
+
+    /* Bytes before the word alignment */
+    for (; (i < size) && (((uintptr_t)&buf[i] & (sizeof(size_t) - 1)) != 0); i++) {
+        if (buf[i] == delim) {
+            return i;
+        }
+    }
+
+    /* A word at a time, until a word has a byte equal to the delimiter */
+    for (; (i + sizeof(size_t)) <= size; i += sizeof(size_t)) {
+        size_t word;
+
+        memcpy(&word, &buf[i], sizeof(word));
+        word ^= pattern;
+        if (((word - SERIAL_FRAME_WORD_ONES) & ~word & SERIAL_FRAME_WORD_HIGHS) != 0) {
+            break;
+        }
+    }
+
+    /* Bytes of the word with the delimiter and after the last word */
+    for (; i < size; i++) {
+        if (buf[i] == delim) {
+            return i;
+        }
+    }
+    return size;
+}
+
+MR_INLINE size_t serial_frame_find_span(struct mr_ringbuf_span *span, size_t offset, uint8_t delim)
+{
+    if (offset < span[0].size) {
+        size_t index = offset + serial_frame_find(&span[0].buffer[offset], span[0].size - offset, delim);
+        if (index < span[0].size) {
+            return index;
+        }
+        offset = span[0].size;
+    }
+    offset -= span[0].size;
+    return span[0].size + offset + serial_frame_find(&span[1].buffer[offset], span[1].size - offset, delim);
+}
+
+MR_INLINE uint8_t serial_frame_get_byte(struct mr_ringbuf_span *span, size_t offset)
+{
+    return (offset < span[0].size) ? span[0].buffer[offset] : span[1].buffer[offset - span[0].size];
+}
+
+MR_INLINE size_t serial_frame_get_len(struct mr_ringbuf_span *span, size_t offset)
+{
+    /* The length prefix is little-endian, as the record head of the ringbuffer */
+    return (size_t)serial_frame_get_byte(span, offset) | ((size_t)serial_frame_get_byte(span, offset + 1) << 8);
+}
+
+MR_INLINE void serial_frame_copy(struct mr_ringbuf_span *span, size_t offset, uint8_t *buf, size_t count)
+{
+    for (size_t i = 0; (i < 2) && (count > 0); i++) {
+        if (offset >= span[i].size) {
+            offset -= span[i].size;
+            continue;
+        }
+        size_t size = MR_MIN(count, span[i].size - offset);
+        memcpy(buf, &span[i].buffer[offset], size);
+        buf += size;
+        count -= size;
+        offset = 0;
+    }
+}
+
+static size_t serial_frame_update(struct mr_serial *serial)
+{
+    struct mr_ringbuf_span span[2];
+    size_t size = mr_ringbuf_read_peek(&serial->rd_fifo, span, mr_ringbuf_get_data_size(&serial->rd_fifo));
+    int delim = serial_frame_get_delim(serial);
+    size_t num = 0;
+
+    /* Count the frames completed by the new data, the scanned data is not scanned again */
+    if (delim >= 0) {
+        while (serial->frame_scan < size) {
+            size_t offset = serial_frame_find_span(span, serial->frame_scan, (uint8_t)delim);
+            if (offset == size) {
+                serial->frame_scan = size;
+                break;
+            }
+            /* The empty frames are only skipped by the read, such as the SLIP frame starting with the end */
+            if (offset != serial->frame_pos) {
+                num++;
+            }
+            serial->frame_pos = serial->frame_scan = offset + 1;
+            serial->frame_num++;
+        }
+    } else if (serial->frame.mode == MR_SERIAL_FRAME_FIXED) {
+        while ((size - serial->frame_pos) >= serial->frame.size) {
+            serial->frame_pos += serial->frame.size;
+            serial->frame_num++;
+            num++;
+        }
+    } else {
+        while ((size - serial->frame_pos) >= 2) {
+            size_t len = serial_frame_get_len(span, serial->frame_pos);
+            if ((size - serial->frame_pos - 2) < len) {
+                break;
+            }
+            serial->frame_pos += 2 + len;
+            serial->frame_num++;
+            num++;
+        }
+    }
+    return num;
+}
+
+static size_t serial_frame_get_size(struct mr_serial *serial, struct mr_ringbuf_span *span)
+{
+    int delim = serial_frame_get_delim(serial);
+
+    if (delim >= 0) {
+        return serial_frame_find_span(span, 0, (uint8_t)delim) + 1;
+    } else if (serial->frame.mode == MR_SERIAL_FRAME_FIXED) {
+        return serial->frame.size;
+    } else {
+        return 2 + serial_frame_get_len(span, 0);
+    }
+}
+
+static ssize_t serial_frame_decode(struct mr_serial *serial,
+                                   struct mr_ringbuf_span *span,
+                                   size_t size,
+                                   uint8_t *buf,
+                                   size_t count)
+{
+    size_t rd_size = 0;
+
+    switch (serial->frame.mode) {
+        case MR_SERIAL_FRAME_LINE: {
+            /* Without the newline and the carriage return before it */
+            size--;
+            if ((size > 0) && (serial_frame_get_byte(span, size - 1) == '\r')) {
+                size--;
+            }
+            rd_size = MR_MIN(size, count);
+            serial_frame_copy(span, 0, buf, rd_size);
+            return (ssize_t)rd_size;
+        }
+        case MR_SERIAL_FRAME_SLIP: {
+            for (size_t i = 0; (i < (size - 1)) && (rd_size < count); i++) {
+                uint8_t data = serial_frame_get_byte(span, i);
+
+                if ((data == SERIAL_FRAME_SLIP_ESC) && ((i + 1) < (size - 1))) {
+                    data = serial_frame_get_byte(span, ++i);
+                    data = (data == SERIAL_FRAME_SLIP_ESC_END) ? SERIAL_FRAME_SLIP_END :
+                           (data == SERIAL_FRAME_SLIP_ESC_ESC) ? SERIAL_FRAME_SLIP_ESC : data;
+                }
+                buf[rd_size++] = data;
+            }
+            return (ssize_t)rd_size;
+        }
+        case MR_SERIAL_FRAME_COBS: {
+            for (size_t i = 0; i < (size - 1);) {
+                uint8_t code = serial_frame_get_byte(span, i++);
+
+                /* The code points past the end of the frame */
+                if ((i + code - 1) > (size - 1)) {
+                    return MR_EIO;
+                }
+                for (size_t j = 1; j < code; j++, i++) {
+                    if (rd_size < count) {
+                        buf[rd_size++] = serial_frame_get_byte(span, i);
+                    }
+                }
+                if ((code < 0xff) && (i < (size - 1)) && (rd_size < count)) {
+                    buf[rd_size++] = 0x00;
+                }
+            }
+            return (ssize_t)rd_size;
+        }
+        case MR_SERIAL_FRAME_LEN: {
+            rd_size = MR_MIN(size - 2, count);
+            serial_frame_copy(span, 2, buf, rd_size);
+            return (ssize_t)rd_size;
+        }
+        default: {
+            rd_size = MR_MIN(size, count);
+            serial_frame_copy(span, 0, buf, rd_size);
+            return (ssize_t)rd_size;
+        }
+    }
+}
+
+static ssize_t serial_frame_read(struct mr_serial *serial, uint8_t *buf, size_t count)
+{
+    /* Nothing can be decoded, keep the frames */
+    if (count == 0) {
+        return 0;
+    }
+
+    while (1) {
+        struct mr_ringbuf_span span[2];
+
+        mr_interrupt_disable();
+        if (serial->frame_num == 0) {
+            /* An incomplete frame that fills the FIFO can never be completed, drop it */
+            if ((mr_ringbuf_get_bufsz(&serial->rd_fifo) != 0) &&
+                (mr_ringbuf_get_space_size(&serial->rd_fifo) == 0)) {
+                mr_ringbuf_reset(&serial->rd_fifo);
+                serial_frame_reset(serial);
+            }
+            mr_interrupt_enable();
+            return 0;
+        }
+        mr_interrupt_enable();
+
+        /* Decode the first frame, a frame larger than the buffer is truncated */
+        mr_ringbuf_read_peek(&serial->rd_fifo, span, mr_ringbuf_get_data_size(&serial->rd_fifo));
+        size_t size = serial_frame_get_size(serial, span);
+        ssize_t ret = serial_frame_decode(serial, span, size, buf, count);
+
+        mr_interrupt_disable();
+        mr_ringbuf_read_consume(&serial->rd_fifo, size);
+        serial->frame_num--;
+        serial->frame_pos -= size;
+        serial->frame_scan = (serial->frame_scan > size) ? (serial->frame_scan - size) : 0;
+        mr_interrupt_enable();
+
+        /* Skip the empty frames and the frames that fail to decode, the buffer is not empty */
+        if (ret > 0) {
+            return ret;
+        }
+    }
+}
+#endif /* MR_USING_SERIAL_FRAME */
+
+MR_INLINE void serial_rd_fifo_push(struct mr_serial *serial, uint8_t data)
+{
+#ifdef MR_USING_SERIAL_FRAME
+    /* Overwriting would break the frames, the new data is dropped instead */
+    if (serial_frame_is_used(serial) == MR_TRUE) {
+        mr_ringbuf_push(&serial->rd_fifo, data);
+        return;
+    }
+#endif /* MR_USING_SERIAL_FRAME */
+    mr_ringbuf_push_force(&serial->rd_fifo, data);
+}
+
+MR_INLINE void serial_rd_fifo_write(struct mr_serial *serial, const uint8_t *buf, size_t count)
+{
+#ifdef MR_USING_SERIAL_FRAME
+    /* Overwriting would break the frames, the new data is dropped instead */
+    if (serial_frame_is_used(serial) == MR_TRUE) {
+        mr_ringbuf_write(&serial->rd_fifo, buf, count);
+        return;
+    }
+#endif /* MR_USING_SERIAL_FRAME */
+    mr_ringbuf_write_force(&serial->rd_fifo, buf, count);
+}
+
 static int mr_serial_open(struct mr_dev *dev)
 {
     struct mr_serial *serial = (struct mr_serial *)dev;
@@ -102,25 +801,29 @@ static int mr_serial_open(struct mr_dev *dev)
     if (ret < 0) {
         return ret;
     }
+#ifdef MR_USING_SERIAL_FRAME
+    serial_frame_reset(serial);
+#endif /* MR_USING_SERIAL_FRAME */
     ret = mr_ringbuf_allocate(&serial->wr_fifo, serial->wr_bufsz);
     if (ret < 0) {
         return ret;
     }
 
 #ifdef MR_USING_SERIAL_DMA
-    serial->dma_rd_buf = (uint8_t *)mr_malloc(serial->dma_rd_bufsz);
+    serial->dma_rd_buf = (uint8_t *)mr_malloc_aligned(serial->dma_rd_bufsz, MR_CFG_SERIAL_DMA_ALIGN, MR_HEAP_DMA);
     if ((serial->dma_rd_buf == MR_NULL) && (serial->dma_rd_bufsz != 0)) {
         return MR_ENOMEM;
     }
-    serial->dma_wr_buf = (uint8_t *)mr_malloc(serial->dma_wr_bufsz);
+    serial->dma_wr_buf = (uint8_t *)mr_malloc_aligned(serial->dma_wr_bufsz, MR_CFG_SERIAL_DMA_ALIGN, MR_HEAP_DMA);
     if ((serial->dma_wr_buf == MR_NULL) && (serial->dma_wr_bufsz != 0)) {
         return MR_ENOMEM;
     }
+#ifdef MR_USING_SERIAL_DMA_TXQ
+    serial_txq_init(serial);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
 
     /* Configure DMA */
-    if ((ops->start_dma_rx != MR_NULL) && (serial->dma_rd_bufsz != 0)) {
-        ops->start_dma_rx(serial, serial->dma_rd_buf, serial->dma_rd_bufsz);
-    }
+    serial_dma_rx_start(serial);
 #endif /* MR_USING_SERIAL_DMA */
 
     return ops->configure(serial, &serial->config);
@@ -136,9 +839,17 @@ static int mr_serial_close(struct mr_dev *dev)
     mr_ringbuf_free(&serial->wr_fifo);
 
 #ifdef MR_USING_SERIAL_DMA
-    mr_free(serial->dma_rd_buf);
-    mr_free(serial->dma_wr_buf);
+    /* Stop DMA before its buffer is freed */
+    serial_dma_rx_stop(serial);
+#ifdef MR_USING_SERIAL_DMA_TXQ
+    serial_txq_abort(serial);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
+    mr_free_aligned(serial->dma_rd_buf);
+    mr_free_aligned(serial->dma_wr_buf);
 #endif /* MR_USING_SERIAL_DMA */
+#ifdef MR_USING_SERIAL_RS485
+    serial_rs485_end(serial);
+#endif /* MR_USING_SERIAL_RS485 */
 
     return ops->configure(serial, &close_config);
 }
@@ -149,6 +860,17 @@ static ssize_t mr_serial_read(struct mr_dev *dev, void *buf, size_t count)
     uint8_t *rd_buf = (uint8_t *)buf;
     ssize_t rd_size;
 
+#ifdef MR_USING_SERIAL_DMA_CIRC
+    if (serial->dma_rd_circ == MR_ENABLE) {
+        return serial_dma_circ_read(serial, rd_buf, count);
+    }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+#ifdef MR_USING_SERIAL_FRAME
+    if (serial_frame_is_used(serial) == MR_TRUE) {
+        return serial_frame_read(serial, rd_buf, count);
+    }
+#endif /* MR_USING_SERIAL_FRAME */
+
     if (mr_ringbuf_get_bufsz(&serial->rd_fifo) == 0) {
         rd_size = serial_poll_read(serial, rd_buf, count);
     } else {
@@ -164,7 +886,16 @@ static ssize_t mr_serial_write(struct mr_dev *dev, const void *buf, size_t count
     ssize_t wr_size;
 
     if (dev->sync == MR_SYNC) {
+#ifdef MR_USING_SERIAL_RS485
+        serial_rs485_poll_begin(serial);
+        wr_size = serial_poll_write(serial, wr_buf, count);
+        int ret = serial_rs485_poll_end(serial);
+        if ((ret < 0) && (wr_size >= 0)) {
+            wr_size = ret;
+        }
+#else
         wr_size = serial_poll_write(serial, wr_buf, count);
+#endif /* MR_USING_SERIAL_RS485 */
     } else {
         wr_size = serial_nonblocking_write(serial, wr_buf, count);
     }
@@ -181,6 +912,12 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 struct mr_serial_config config = *(struct mr_serial_config *)args;
 
+#ifdef MR_USING_SERIAL_DMA_TXQ
+                /* The queued requests are transmitted without holding the device */
+                if (mr_list_is_empty(&serial->tx_list) == MR_FALSE) {
+                    return MR_EBUSY;
+                }
+#endif /* MR_USING_SERIAL_DMA_TXQ */
                 int ret = ops->configure(serial, &config);
                 if (ret < 0) {
                     return ret;
@@ -195,11 +932,14 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
                 size_t bufsz = *(size_t *)args;
 
                 int ret = mr_ringbuf_allocate(&serial->rd_fifo, bufsz);
+#ifdef MR_USING_SERIAL_FRAME
+                serial_frame_reset(serial);
+#endif /* MR_USING_SERIAL_FRAME */
                 serial->rd_bufsz = 0;
                 if (ret < 0) {
                     return ret;
                 }
-                serial->rd_bufsz = bufsz;
+                serial->rd_bufsz = mr_ringbuf_get_bufsz(&serial->rd_fifo);
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
@@ -213,16 +953,74 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
                 if (ret < 0) {
                     return ret;
                 }
-                serial->wr_bufsz = bufsz;
+                serial->wr_bufsz = mr_ringbuf_get_bufsz(&serial->wr_fifo);
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
         }
         case MR_IOC_SERIAL_CLR_RD_BUF: {
+#ifdef MR_USING_SERIAL_DMA_CIRC
+            if (serial->dma_rd_circ == MR_ENABLE) {
+                mr_interrupt_disable();
+                serial->dma_rd_rpos = serial->dma_rd_wpos;
+                serial->dma_rd_out = serial->dma_rd_in;
+                mr_interrupt_enable();
+                return MR_EOK;
+            }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+            mr_interrupt_disable();
             mr_ringbuf_reset(&serial->rd_fifo);
+#ifdef MR_USING_SERIAL_FRAME
+            serial_frame_reset(serial);
+#endif /* MR_USING_SERIAL_FRAME */
+            mr_interrupt_enable();
             return MR_EOK;
         }
+#ifdef MR_USING_SERIAL_FRAME
+        case MR_IOC_SERIAL_SET_FRAME: {
+            if (args != MR_NULL) {
+                struct mr_serial_frame_config frame = *(struct mr_serial_frame_config *)args;
+
+                if ((frame.mode < MR_SERIAL_FRAME_NONE) || (frame.mode > MR_SERIAL_FRAME_FIXED) ||
+                    ((frame.mode == MR_SERIAL_FRAME_FIXED) && (frame.size == 0))) {
+                    return MR_EINVAL;
+                }
+#ifdef MR_USING_SERIAL_DMA_CIRC
+                /* The circular DMA buffer is not delimited */
+                if ((serial->dma_rd_circ == MR_ENABLE) && (frame.mode != MR_SERIAL_FRAME_NONE)) {
+                    return MR_ENOTSUP;
+                }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+
+                /* The data received before is not delimited in the new mode */
+                mr_interrupt_disable();
+                serial->frame = frame;
+                mr_ringbuf_reset(&serial->rd_fifo);
+                serial_frame_reset(serial);
+                mr_interrupt_enable();
+                return sizeof(frame);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_FRAME */
+#ifdef MR_USING_SERIAL_RS485
+        case MR_IOC_SERIAL_SET_RS485: {
+            if (args != MR_NULL) {
+                struct mr_serial_rs485_config config = *(struct mr_serial_rs485_config *)args;
+
+                int ret = serial_rs485_configure(serial, &config);
+                if (ret < 0) {
+                    return ret;
+                }
+                return sizeof(config);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_RS485 */
         case MR_IOC_SERIAL_CLR_WR_BUF: {
+#ifdef MR_USING_SERIAL_DMA_TXQ
+            serial_txq_clear(serial);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
             mr_ringbuf_reset(&serial->wr_fifo);
             return MR_EOK;
         }
@@ -235,11 +1033,33 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             }
             return MR_EINVAL;
         }
+#ifdef MR_USING_SERIAL_FRAME
+        case MR_IOC_SERIAL_GET_FRAME: {
+            if (args != MR_NULL) {
+                struct mr_serial_frame_config *frame = (struct mr_serial_frame_config *)args;
+
+                *frame = serial->frame;
+                return sizeof(*frame);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_FRAME */
+#ifdef MR_USING_SERIAL_RS485
+        case MR_IOC_SERIAL_GET_RS485: {
+            if (args != MR_NULL) {
+                struct mr_serial_rs485_config *config = (struct mr_serial_rs485_config *)args;
+
+                *config = serial->rs485;
+                return sizeof(*config);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_RS485 */
         case MR_IOC_SERIAL_GET_RD_BUFSZ: {
             if (args != MR_NULL) {
                 size_t *bufsz = (size_t *)args;
 
-                *bufsz = serial->rd_bufsz;
+                *bufsz = mr_ringbuf_get_bufsz(&serial->rd_fifo);
                 return sizeof(*bufsz);
             }
             return MR_EINVAL;
@@ -248,7 +1068,7 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *bufsz = (size_t *)args;
 
-                *bufsz = serial->wr_bufsz;
+                *bufsz = mr_ringbuf_get_bufsz(&serial->wr_fifo);
                 return sizeof(*bufsz);
             }
             return MR_EINVAL;
@@ -257,6 +1077,12 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *datasz = (size_t *)args;
 
+#ifdef MR_USING_SERIAL_DMA_CIRC
+                if (serial->dma_rd_circ == MR_ENABLE) {
+                    *datasz = serial_dma_circ_get_data_size(serial);
+                    return sizeof(*datasz);
+                }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
                 *datasz = mr_ringbuf_get_data_size(&serial->rd_fifo);
                 return sizeof(*datasz);
             }
@@ -266,6 +1092,12 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *datasz = (size_t *)args;
 
+#ifdef MR_USING_SERIAL_DMA_TXQ
+                if ((ops->start_dma_tx != MR_NULL) && (ops->stop_dma_tx != MR_NULL)) {
+                    *datasz = serial_txq_get_data_size(serial);
+                    return sizeof(*datasz);
+                }
+#endif /* MR_USING_SERIAL_DMA_TXQ */
                 *datasz = mr_ringbuf_get_data_size(&serial->wr_fifo);
                 return sizeof(*datasz);
             }
@@ -276,21 +1108,21 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t bufsz = *(size_t *)args;
 
-                if (ops->stop_dma_rx) {
+                if (ops->stop_dma_rx == MR_NULL) {
                     return MR_EIO;
                 }
-                ops->stop_dma_rx(serial);
+                serial_dma_rx_stop(serial);
 
-                uint8_t *pool = mr_realloc(serial->dma_rd_buf, bufsz);
-                if ((pool == MR_NULL) && (bufsz != 0)) {
+                /* Free the old buffer first, so that resizing does not need both buffers */
+                mr_free_aligned(serial->dma_rd_buf);
+                serial->dma_rd_buf = (uint8_t *)mr_malloc_aligned(bufsz, MR_CFG_SERIAL_DMA_ALIGN, MR_HEAP_DMA);
+                if ((serial->dma_rd_buf == MR_NULL) && (bufsz != 0)) {
+                    serial->dma_rd_bufsz = 0;
                     return MR_ENOMEM;
                 }
-                serial->dma_rd_buf = pool;
                 serial->dma_rd_bufsz = bufsz;
 
-                if ((ops->start_dma_rx != MR_NULL) && (serial->dma_rd_bufsz != 0)) {
-                    ops->start_dma_rx(serial, serial->dma_rd_buf, serial->dma_rd_bufsz);
-                }
+                serial_dma_rx_start(serial);
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
@@ -299,12 +1131,27 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t bufsz = *(size_t *)args;
 
-                uint8_t *pool = mr_realloc(serial->dma_wr_buf, bufsz);
-                if ((pool == MR_NULL) && (bufsz != 0)) {
+#ifdef MR_USING_SERIAL_DMA_TXQ
+                /* The staging buffers may be in flight */
+                if (mr_list_is_empty(&serial->tx_list) == MR_FALSE) {
+                    return MR_EBUSY;
+                }
+#endif /* MR_USING_SERIAL_DMA_TXQ */
+
+                /* Free the old buffer first, so that resizing does not need both buffers */
+                mr_free_aligned(serial->dma_wr_buf);
+                serial->dma_wr_buf = (uint8_t *)mr_malloc_aligned(bufsz, MR_CFG_SERIAL_DMA_ALIGN, MR_HEAP_DMA);
+                if ((serial->dma_wr_buf == MR_NULL) && (bufsz != 0)) {
+                    serial->dma_wr_bufsz = 0;
+#ifdef MR_USING_SERIAL_DMA_TXQ
+                    serial_txq_init(serial);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
                     return MR_ENOMEM;
                 }
-                serial->dma_wr_buf = pool;
                 serial->dma_wr_bufsz = bufsz;
+#ifdef MR_USING_SERIAL_DMA_TXQ
+                serial_txq_init(serial);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
@@ -327,6 +1174,52 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
             }
             return MR_EINVAL;
         }
+#ifdef MR_USING_SERIAL_DMA_TXQ
+        case MR_IOC_SERIAL_QUEUE_WR_DMA: {
+            if (args != MR_NULL) {
+                struct mr_serial_tx *tx = (struct mr_serial_tx *)args;
+
+                if ((tx->buf == MR_NULL) || (tx->count == 0)) {
+                    return MR_EINVAL;
+                }
+                if ((ops->start_dma_tx == MR_NULL) || (ops->stop_dma_tx == MR_NULL)) {
+                    return MR_EIO;
+                }
+
+                /* Small requests are coalesced into the staging buffers and completed at once */
+                if ((tx->count <= MR_CFG_SERIAL_DMA_TXQ_COPY) &&
+                    (serial_txq_write(serial, tx->buf, tx->count, MR_TRUE) > 0)) {
+                    tx->ret = (ssize_t)tx->count;
+                    if (tx->done != MR_NULL) {
+                        tx->done(tx);
+                    }
+                    return sizeof(*tx);
+                }
+
+                /* Transmit in place */
+                tx->ret = 0;
+                mr_interrupt_disable();
+                mr_list_insert_before(&serial->tx_list, &tx->list);
+                if (serial->nonblock_state == MR_DISABLE) {
+                    serial_txq_start(serial);
+                }
+                mr_interrupt_enable();
+                return sizeof(*tx);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_DMA_TXQ */
+#ifdef MR_USING_SERIAL_DMA_CIRC
+        case MR_IOC_SERIAL_GET_RD_DMA_LOST: {
+            if (args != MR_NULL) {
+                size_t *lost = (size_t *)args;
+
+                *lost = serial->dma_rd_lost;
+                return sizeof(*lost);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
 #endif /* MR_USING_SERIAL_DMA */
         default: {
             return MR_ENOTSUP;
@@ -334,7 +1227,73 @@ static int mr_serial_ioctl(struct mr_dev *dev, int cmd, void *args)
     }
 }
 
-static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
+MR_INLINE ssize_t serial_burst_read_isr(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+    struct mr_ringbuf_span span[2];
+    size_t size = 0;
+    ssize_t ret = 0;
+
+    /* Drain the hardware FIFO straight into the free space of the FIFO */
+    size_t count = mr_ringbuf_write_reserve(&serial->rd_fifo, span, mr_ringbuf_get_bufsz(&serial->rd_fifo));
+    for (size_t i = 0; (i < MR_ARRAY_NUM(span)) && (size < count); i++) {
+        ret = ops->read_burst(serial, span[i].buffer, span[i].size);
+        if (ret < 0) {
+            break;
+        }
+        size += ret;
+        if ((size_t)ret < span[i].size) {
+            break;
+        }
+    }
+    mr_ringbuf_write_commit(&serial->rd_fifo, size);
+
+    /* The FIFO is full, keep the newest data like pushing by force, until the hardware FIFO is empty */
+    if ((size == count) && (ret >= 0)) {
+        uint8_t buf[16];
+
+        do {
+            ret = ops->read_burst(serial, buf, sizeof(buf));
+            if (ret <= 0) {
+                break;
+            }
+            serial_rd_fifo_write(serial, buf, ret);
+            size += ret;
+        } while ((size_t)ret == sizeof(buf));
+    }
+    return (size == 0) ? ((ret < 0) ? ret : MR_EBUSY) : MR_EOK;
+}
+
+MR_INLINE ssize_t serial_burst_write_isr(struct mr_serial *serial)
+{
+    struct mr_serial_ops *ops = (struct mr_serial_ops *)serial->dev.drv->ops;
+    struct mr_ringbuf_span span[2];
+    size_t size = 0;
+
+    /* Write data from FIFO, if FIFO is empty, stop transmit */
+    size_t count = mr_ringbuf_read_peek(&serial->wr_fifo, span, mr_ringbuf_get_bufsz(&serial->wr_fifo));
+    if (count == 0) {
+        serial->nonblock_state = MR_DISABLE;
+        ops->stop_tx(serial);
+        return MR_EOK;
+    }
+
+    /* Fill the hardware FIFO straight out of the FIFO */
+    for (size_t i = 0; (i < MR_ARRAY_NUM(span)) && (size < count); i++) {
+        ssize_t ret = ops->write_burst(serial, span[i].buffer, span[i].size);
+        if (ret < 0) {
+            break;
+        }
+        size += ret;
+        if ((size_t)ret < span[i].size) {
+            break;
+        }
+    }
+    mr_ringbuf_read_consume(&serial->wr_fifo, size);
+    return MR_EBUSY;
+}
+
+static ssize_t serial_isr(struct mr_dev *dev, int event, void *args)
 {
     struct mr_serial *serial = (struct mr_serial *)dev;
     struct mr_serial_ops *ops = (struct mr_serial_ops *)dev->drv->ops;
@@ -343,17 +1302,27 @@ static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
         case MR_ISR_SERIAL_RD_INT: {
             uint8_t data;
 
+            /* Read the whole hardware FIFO at once, the callback is called once for it */
+            if (ops->read_burst != MR_NULL) {
+                return serial_burst_read_isr(serial);
+            }
+
             /* Read data to FIFO */
             int ret = ops->read(serial, &data);
             if (ret < 0) {
                 return ret;
             }
-            mr_ringbuf_push_force(&serial->rd_fifo, data);
+            serial_rd_fifo_push(serial, data);
             return MR_EOK;
         }
         case MR_ISR_SERIAL_WR_INT: {
             uint8_t data;
 
+            /* Fill the whole hardware FIFO at once */
+            if (ops->write_burst != MR_NULL) {
+                return serial_burst_write_isr(serial);
+            }
+
             /* Write data from FIFO, if FIFO is empty, stop transmit */
             if (mr_ringbuf_pop(&serial->wr_fifo, &data) == sizeof(data)) {
                 ops->write(serial, data);
@@ -364,14 +1333,23 @@ static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
                 return MR_EOK;
             }
         }
+#ifdef MR_USING_SERIAL_RS485
+        case MR_ISR_SERIAL_WR_TC: {
+            /* Release the DE once the nonblocking transfer has left the shift register */
+            if ((serial->nonblock_state == MR_DISABLE) && (serial->rs485_state == SERIAL_RS485_NONBLOCK)) {
+                serial_rs485_end(serial);
+            }
+            return MR_EBUSY;
+        }
+#endif /* MR_USING_SERIAL_RS485 */
 #ifdef MR_USING_SERIAL_DMA
         case MR_ISR_SERIAL_RD_DMA: {
             if (args != MR_NULL) {
                 size_t dma_rx_datasz = *(size_t *)args;
 
-                mr_ringbuf_write_force(&serial->rd_fifo,
-                                       serial->dma_rd_buf,
-                                       MR_BOUND(dma_rx_datasz, 0, serial->dma_rd_bufsz));
+                serial_rd_fifo_write(serial,
+                                     serial->dma_rd_buf,
+                                     MR_BOUND(dma_rx_datasz, 0, serial->dma_rd_bufsz));
                 if (ops->start_dma_rx != MR_NULL) {
                     ops->start_dma_rx(serial, serial->dma_rd_buf, serial->dma_rd_bufsz);
                 }
@@ -379,7 +1357,43 @@ static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
             }
             return MR_EINVAL;
         }
+#ifdef MR_USING_SERIAL_DMA_CIRC
+        case MR_ISR_SERIAL_RD_DMA_POS: {
+            if ((args != MR_NULL) && (serial->dma_rd_circ == MR_ENABLE)) {
+                /* Position written by DMA (buffer size minus the remaining count), the end wraps around to 0 */
+                size_t position = *(size_t *)args % serial->dma_rd_bufsz;
+                size_t size = (position + serial->dma_rd_bufsz - serial->dma_rd_wpos) % serial->dma_rd_bufsz;
+
+                /*
+                 * Nothing new, such as an idle-line right after a transfer-complete. A whole lap gives the same
+                 * position, so the reports must come within half of the buffer (half-transfer and transfer-complete)
+                 */
+                if (size == 0) {
+                    return MR_EBUSY;
+                }
+                serial->dma_rd_wpos = position;
+                serial->dma_rd_in += size;
+                return MR_EOK;
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_SERIAL_DMA_CIRC */
         case MR_ISR_SERIAL_WR_DMA: {
+#ifdef MR_USING_SERIAL_DMA_TXQ
+            /* Complete the request in flight and transmit the next one */
+            if (mr_list_is_empty(&serial->tx_list) == MR_FALSE) {
+                struct mr_serial_tx *tx = MR_CONTAINER_OF(serial->tx_list.next, struct mr_serial_tx, list);
+
+                mr_list_remove(&tx->list);
+                if (serial_txq_is_stage(serial, tx) == MR_TRUE) {
+                    tx->count = 0;
+                } else if (tx->done != MR_NULL) {
+                    tx->ret = (ssize_t)tx->count;
+                    tx->done(tx);
+                }
+            }
+            return serial_txq_start(serial);
+#else
             if (serial->dma_wr_bufsz == 0) {
                 serial->nonblock_state = MR_DISABLE;
                 ops->stop_dma_tx(serial);
@@ -397,6 +1411,7 @@ static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
                     return MR_EOK;
                 }
             }
+#endif /* MR_USING_SERIAL_DMA_TXQ */
         }
 #endif /* MR_USING_SERIAL_DMA */
         default: {
@@ -405,6 +1420,20 @@ static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
     }
 }
 
+static ssize_t mr_serial_isr(struct mr_dev *dev, int event, void *args)
+{
+    ssize_t ret = serial_isr(dev, event, args);
+
+#ifdef MR_USING_SERIAL_FRAME
+    /* Notify the read only when frames are completed */
+    if ((ret >= 0) && ((event & MR_ISR_MASK) == MR_ISR_RD) &&
+        (serial_frame_is_used((struct mr_serial *)dev) == MR_TRUE)) {
+        return (serial_frame_update((struct mr_serial *)dev) > 0) ? MR_EOK : MR_EBUSY;
+    }
+#endif /* MR_USING_SERIAL_FRAME */
+    return ret;
+}
+
 /**
  * @brief This function register a serial.
  *
@@ -421,7 +1450,9 @@ int mr_serial_register(struct mr_serial *serial, const char *path, struct mr_drv
                                     mr_serial_read,
                                     mr_serial_write,
                                     mr_serial_ioctl,
-                                    mr_serial_isr};
+                                    mr_serial_isr,
+                                    MR_NULL,
+                                    MR_NULL};
     struct mr_serial_config default_config = MR_SERIAL_CONFIG_DEFAULT;
 
     MR_ASSERT(serial != MR_NULL);
@@ -441,6 +1472,18 @@ int mr_serial_register(struct mr_serial *serial, const char *path, struct mr_drv
 #endif /* MR_CFG_SERIAL_WR_BUFSZ */
     serial->rd_bufsz = MR_CFG_SERIAL_RD_BUFSZ;
     serial->wr_bufsz = MR_CFG_SERIAL_WR_BUFSZ;
+#ifdef MR_USING_SERIAL_FRAME
+    serial->frame.mode = MR_SERIAL_FRAME_NONE;
+    serial->frame.size = 0;
+    serial_frame_reset(serial);
+#endif /* MR_USING_SERIAL_FRAME */
+#ifdef MR_USING_SERIAL_RS485
+    serial->rs485.pin = -1;
+    serial->rs485.level = 1;
+    serial->rs485.pre_delay = 0;
+    serial->rs485.post_delay = 0;
+    serial->rs485_state = SERIAL_RS485_IDLE;
+#endif /* MR_USING_SERIAL_RS485 */
 #ifdef MR_USING_SERIAL_DMA
     serial->dma_rd_buf = MR_NULL;
     serial->dma_wr_buf = MR_NULL;
@@ -452,6 +1495,18 @@ int mr_serial_register(struct mr_serial *serial, const char *path, struct mr_drv
 #endif /* MR_CFG_SERIAL_WR_DMA_BUFSZ */
     serial->dma_rd_bufsz = MR_CFG_SERIAL_RD_DMA_BUFSZ;
     serial->dma_wr_bufsz = MR_CFG_SERIAL_WR_DMA_BUFSZ;
+#ifdef MR_USING_SERIAL_DMA_CIRC
+    serial->dma_rd_circ = MR_DISABLE;
+    serial->dma_rd_wpos = 0;
+    serial->dma_rd_rpos = 0;
+    serial->dma_rd_in = 0;
+    serial->dma_rd_out = 0;
+    serial->dma_rd_lost = 0;
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+#ifdef MR_USING_SERIAL_DMA_TXQ
+    mr_list_init(&serial->tx_list);
+    serial_txq_init(serial);
+#endif /* MR_USING_SERIAL_DMA_TXQ */
 #endif /* MR_USING_SERIAL_DMA */
     serial->nonblock_state = MR_DISABLE;
 
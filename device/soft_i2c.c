@@ -12,9 +12,6 @@
 
 #ifdef MR_USING_PIN
 #include "include/device/mr_pin.h"
-int _mr_fast_pin_mode(int number, int mode);
-uint8_t _mr_fast_pin_read(int number);
-void _mr_fast_pin_write(int number, int value);
 #else
 #error "Please define MR_USING_PIN. Otherwise Soft-I2C will not work."
 #endif /* MR_USING_PIN */
@@ -96,7 +96,9 @@ int mr_spi_bus_register(struct mr_spi_bus *spi_bus, const char *path, struct mr_
                                     mr_spi_bus_read,
                                     mr_spi_bus_write,
                                     MR_NULL,
-                                    mr_spi_bus_isr};
+                                    mr_spi_bus_isr,
+                                    MR_NULL,
+                                    MR_NULL};
     struct mr_spi_config default_config = MR_SPI_CONFIG_DEFAULT;
 
     MR_ASSERT(spi_bus != MR_NULL);
@@ -168,12 +170,18 @@ MR_INLINE int spi_dev_take_bus(struct mr_spi_dev *spi_dev)
     struct mr_spi_bus *spi_bus = (struct mr_spi_bus *)spi_dev->dev.parent;
     struct mr_spi_bus_ops *ops = (struct mr_spi_bus_ops *)spi_bus->dev.drv->ops;
 
-    /* Check if the bus is busy */
+    /* Check if the bus is busy and hold it at once, the siblings on other threads see it busy */
+    mr_interrupt_disable();
     if ((spi_bus->hold == MR_TRUE) && (spi_dev != spi_bus->owner)) {
+        mr_interrupt_enable();
         return MR_EBUSY;
     }
+    int owner_changed = (spi_dev != spi_bus->owner);
+    spi_bus->owner = spi_dev;
+    spi_bus->hold = MR_TRUE;
+    mr_interrupt_enable();
 
-    if (spi_dev != spi_bus->owner) {
+    if (owner_changed == MR_TRUE) {
         /* Reconfigure the bus */
         if (spi_dev->config.baud_rate != spi_bus->config.baud_rate ||
             spi_dev->config.host_slave != spi_bus->config.host_slave ||
@@ -181,18 +189,21 @@ MR_INLINE int spi_dev_take_bus(struct mr_spi_dev *spi_dev)
             spi_dev->config.bit_order != spi_bus->config.bit_order) {
             int ret = ops->configure(spi_bus, &spi_dev->config);
             if (ret < 0) {
+                /* Give up the bus, the next owner rechecks the configuration */
+                mr_interrupt_disable();
+                spi_bus->owner = MR_NULL;
+                spi_bus->hold = MR_FALSE;
+                mr_interrupt_enable();
                 return ret;
             }
         }
         spi_bus->config = spi_dev->config;
-        spi_bus->owner = spi_dev;
 #ifdef MR_USING_PIN
         if ((spi_bus->cs_desc >= 0) && (spi_bus->config.host_slave == MR_SPI_HOST)) {
             mr_dev_ioctl(spi_bus->cs_desc, MR_IOC_SPOS, MR_MAKE_LOCAL(int, spi_dev->cs_pin));
         }
 #endif /* MR_USING_PIN */
     }
-    spi_bus->hold = MR_TRUE;
     return MR_EOK;
 }
 
@@ -200,7 +211,9 @@ MR_INLINE int spi_dev_release_bus(struct mr_spi_dev *spi_dev)
 {
     struct mr_spi_bus *spi_bus = (struct mr_spi_bus *)spi_dev->dev.parent;
 
+    mr_interrupt_disable();
     if (spi_dev != spi_bus->owner) {
+        mr_interrupt_enable();
         return MR_EINVAL;
     }
 
@@ -208,6 +221,7 @@ MR_INLINE int spi_dev_release_bus(struct mr_spi_dev *spi_dev)
     if (spi_dev->config.host_slave == MR_SPI_HOST) {
         spi_bus->hold = MR_FALSE;
     }
+    mr_interrupt_enable();
     return MR_EOK;
 }
 
@@ -288,7 +302,31 @@ static int mr_spi_dev_close(struct mr_dev *dev)
     return MR_EOK;
 }
 
-static ssize_t mr_spi_dev_read(struct mr_dev *dev, void *buf, size_t count)
+static ssize_t spi_dev_transfer_iov(struct mr_spi_dev *spi_dev,
+                                    const struct mr_dev_iovec *iov,
+                                    size_t iovcnt,
+                                    int rdwr)
+{
+    ssize_t tf_size = 0;
+
+    for (size_t i = 0; i < iovcnt; i++) {
+        ssize_t ret = spi_dev_transfer(spi_dev,
+                                       (rdwr == MR_SPI_RD) ? (uint8_t *)iov[i].buf : MR_NULL,
+                                       (rdwr == MR_SPI_WR) ? (const uint8_t *)iov[i].buf : MR_NULL,
+                                       iov[i].count,
+                                       rdwr);
+        if (ret < 0) {
+            return (tf_size == 0) ? ret : tf_size;
+        }
+        tf_size += ret;
+        if ((size_t)ret < iov[i].count) {
+            break;
+        }
+    }
+    return tf_size;
+}
+
+static ssize_t mr_spi_dev_readv(struct mr_dev *dev, const struct mr_dev_iovec *iov, size_t iovcnt)
 {
     struct mr_spi_dev *spi_dev = (struct mr_spi_dev *)dev;
 
@@ -314,17 +352,25 @@ static ssize_t mr_spi_dev_read(struct mr_dev *dev, void *buf, size_t count)
             }
         }
 
-        ret = spi_dev_transfer(spi_dev, buf, MR_NULL, count, MR_SPI_RD);
+        /* Read all buffers in one chip select */
+        ret = spi_dev_transfer_iov(spi_dev, iov, iovcnt, MR_SPI_RD);
         spi_dev_cs_set(spi_dev, MR_DISABLE);
     } else {
-        ret = (ssize_t)mr_ringbuf_read(&spi_dev->rd_fifo, buf, count);
+        ret = 0;
+        for (size_t i = 0; i < iovcnt; i++) {
+            size_t size = mr_ringbuf_read(&spi_dev->rd_fifo, iov[i].buf, iov[i].count);
+            ret += (ssize_t)size;
+            if (size < iov[i].count) {
+                break;
+            }
+        }
     }
 
     spi_dev_release_bus(spi_dev);
     return ret;
 }
 
-static ssize_t mr_spi_dev_write(struct mr_dev *dev, const void *buf, size_t count)
+static ssize_t mr_spi_dev_writev(struct mr_dev *dev, const struct mr_dev_iovec *iov, size_t iovcnt)
 {
     struct mr_spi_dev *spi_dev = (struct mr_spi_dev *)dev;
 
@@ -350,16 +396,31 @@ static ssize_t mr_spi_dev_write(struct mr_dev *dev, const void *buf, size_t coun
             }
         }
 
-        ret = spi_dev_transfer(spi_dev, MR_NULL, buf, count, MR_SPI_WR);
+        /* Write all buffers in one chip select */
+        ret = spi_dev_transfer_iov(spi_dev, iov, iovcnt, MR_SPI_WR);
         spi_dev_cs_set(spi_dev, MR_DISABLE);
     } else {
-        ret = spi_dev_transfer(spi_dev, MR_NULL, buf, count, MR_SPI_WR);
+        ret = spi_dev_transfer_iov(spi_dev, iov, iovcnt, MR_SPI_WR);
     }
 
     spi_dev_release_bus(spi_dev);
     return ret;
 }
 
+static ssize_t mr_spi_dev_read(struct mr_dev *dev, void *buf, size_t count)
+{
+    struct mr_dev_iovec iov = {buf, count};
+
+    return mr_spi_dev_readv(dev, &iov, 1);
+}
+
+static ssize_t mr_spi_dev_write(struct mr_dev *dev, const void *buf, size_t count)
+{
+    struct mr_dev_iovec iov = {(void *)buf, count};
+
+    return mr_spi_dev_writev(dev, &iov, 1);
+}
+
 static int mr_spi_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
 {
     struct mr_spi_dev *spi_dev = (struct mr_spi_dev *)dev;
@@ -379,10 +440,12 @@ static int mr_spi_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
 #endif /* MR_USING_PIN */
 
                 /* If holding the bus, release it */
+                mr_interrupt_disable();
                 if (spi_dev == spi_bus->owner) {
                     spi_bus->hold = MR_FALSE;
                     spi_bus->owner = MR_NULL;
                 }
+                mr_interrupt_enable();
 
                 /* Update the configuration and try again to get the bus */
                 spi_dev->config = config;
@@ -405,7 +468,7 @@ static int mr_spi_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
                 if (ret < 0) {
                     return ret;
                 }
-                spi_dev->rd_bufsz = bufsz;
+                spi_dev->rd_bufsz = mr_ringbuf_get_bufsz(&spi_dev->rd_fifo);
                 return sizeof(bufsz);
             }
             return MR_EINVAL;
@@ -457,7 +520,7 @@ static int mr_spi_dev_ioctl(struct mr_dev *dev, int cmd, void *args)
             if (args != MR_NULL) {
                 size_t *bufsz = (size_t *)args;
 
-                *bufsz = spi_dev->rd_bufsz;
+                *bufsz = mr_ringbuf_get_bufsz(&spi_dev->rd_fifo);
                 return sizeof(*bufsz);
             }
             return MR_EINVAL;
@@ -494,7 +557,9 @@ int mr_spi_dev_register(struct mr_spi_dev *spi_dev, const char *path, int cs_pin
                                     mr_spi_dev_read,
                                     mr_spi_dev_write,
                                     mr_spi_dev_ioctl,
-                                    MR_NULL};
+                                    MR_NULL,
+                                    mr_spi_dev_readv,
+                                    mr_spi_dev_writev};
     struct mr_spi_config default_config = MR_SPI_CONFIG_DEFAULT;
 
     MR_ASSERT(spi_dev != MR_NULL);
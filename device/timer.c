@@ -226,7 +226,9 @@ int mr_timer_register(struct mr_timer *timer,
                                     mr_timer_read,
                                     mr_timer_write,
                                     mr_timer_ioctl,
-                                    mr_timer_isr};
+                                    mr_timer_isr,
+                                    MR_NULL,
+                                    MR_NULL};
     struct mr_timer_config default_config = MR_TIMER_CONFIG_DEFAULT;
 
     MR_ASSERT(timer != MR_NULL);
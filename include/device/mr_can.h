@@ -59,13 +59,13 @@ struct mr_can_config
 
 #define MR_IOC_CAN_GET_CONFIG           MR_IOC_GCFG                 /**< Get configuration command */
 #define MR_IOC_CAN_GET_RD_BUFSZ         MR_IOC_GRBSZ                /**< Get read buffer size command */
-#define MR_IOC_CAN_GET_RD_DATASZ        MR_IOC_GRBDSZ               /**< Get read data size command */
+#define MR_IOC_CAN_GET_RD_DATASZ        MR_IOC_GRBDSZ               /**< Get read data size (next frame) command */
 #define MR_IOC_CAN_GET_RD_CALL          MR_IOC_GRCB                 /**< Get read callback command */
 
 /**
  * @brief CAN data type.
  */
-typedef uint8_t mr_can_data_t;                                      /**< CAN read/write data type */
+typedef uint8_t mr_can_data_t;                                      /**< CAN data type (one frame per read) */
 
 /**
 * @brief CAN ISR events.
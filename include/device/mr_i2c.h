@@ -67,7 +67,7 @@ struct mr_i2c_config
 #define MR_IOC_I2C_GET_CONFIG           MR_IOC_GCFG                 /**< Get configuration command */
 #define MR_IOC_I2C_GET_REG              MR_IOC_GPOS                 /**< Get register command */
 #define MR_IOC_I2C_GET_RD_BUFSZ         MR_IOC_GRBSZ                /**< Get read buffer size command */
-#define MR_IOC_I2C_GET_RD_DATASZ        MR_IOC_GRBDSZ               /**< Get read data size command */
+#define MR_IOC_I2C_GET_RD_DATASZ        MR_IOC_GRBDSZ               /**< Get read data size (bytes) command */
 #define MR_IOC_I2C_GET_RD_CALL          MR_IOC_GRCB                 /**< Get read callback command */
 
 /**
@@ -91,6 +91,14 @@ struct mr_pin_ops
 };
 
 int mr_pin_register(struct mr_pin *pin, const char *path, struct mr_drv *drv);
+
+/**
+ * @brief Fast pin functions, for the device drivers only (not the application layer).
+ */
+void _mr_fast_pin_init(struct mr_dev *dev);
+int _mr_fast_pin_mode(int number, int mode);
+uint8_t _mr_fast_pin_read(int number);
+void _mr_fast_pin_write(int number, int value);
 /** @} */
 
 #endif /* MR_USING_PIN */
@@ -57,6 +57,42 @@ extern "C" {
 #define MR_SERIAL_POLARITY_NORMAL       (0)                         /**< Normal polarity */
 #define MR_SERIAL_POLARITY_INVERTED     (1)                         /**< Inverted polarity */
 
+#ifdef MR_USING_SERIAL_FRAME
+/**
+ * @brief Serial frame mode.
+ */
+#define MR_SERIAL_FRAME_NONE            (0)                         /**< No framing */
+#define MR_SERIAL_FRAME_LINE            (1)                         /**< Newline terminated line */
+#define MR_SERIAL_FRAME_SLIP            (2)                         /**< SLIP */
+#define MR_SERIAL_FRAME_COBS            (3)                         /**< COBS, zero terminated */
+#define MR_SERIAL_FRAME_LEN             (4)                         /**< 16-bit little-endian length prefixed */
+#define MR_SERIAL_FRAME_FIXED           (5)                         /**< Fixed size */
+
+/**
+ * @brief Serial frame configuration structure.
+ */
+struct mr_serial_frame_config
+{
+    int mode;                                                       /**< Frame mode */
+    size_t size;                                                    /**< Frame size (fixed size mode) */
+};
+#endif /* MR_USING_SERIAL_FRAME */
+
+#ifdef MR_USING_SERIAL_RS485
+/**
+ * @brief Serial RS-485 configuration structure.
+ *
+ * @note The delays are bounded by MR_CFG_SERIAL_RS485_DELAY_MAX.
+ */
+struct mr_serial_rs485_config
+{
+    int pin;                                                        /**< DE/RE pin number (negative is disabled) */
+    int level;                                                      /**< DE active level */
+    uint32_t pre_delay;                                             /**< Delay before transmitting (us) */
+    uint32_t post_delay;                                            /**< Delay after transmit-complete (us) */
+};
+#endif /* MR_USING_SERIAL_RS485 */
+
 /**
  * @brief Serial default configuration.
  */
@@ -102,12 +138,27 @@ struct mr_serial_config
 #define MR_IOC_SERIAL_GET_RD_CALL       MR_IOC_GRCB                 /**< Get read callback command */
 #define MR_IOC_SERIAL_GET_WR_CALL       MR_IOC_GWCB                 /**< Get write callback command */
 
+#ifdef MR_USING_SERIAL_FRAME
+#define MR_IOC_SERIAL_SET_FRAME         (0x04)                      /**< Set frame configuration command */
+#define MR_IOC_SERIAL_GET_FRAME         (-(0x04))                   /**< Get frame configuration command */
+#endif /* MR_USING_SERIAL_FRAME */
+#ifdef MR_USING_SERIAL_RS485
+#define MR_IOC_SERIAL_SET_RS485         (0x05)                      /**< Set RS-485 configuration command */
+#define MR_IOC_SERIAL_GET_RS485         (-(0x05))                   /**< Get RS-485 configuration command */
+#endif /* MR_USING_SERIAL_RS485 */
+
 #ifdef MR_USING_SERIAL_DMA
 #define MR_IOC_SERIAL_SET_RD_DMA_BUFSZ  (0x01)                      /**< Set read DMA buffer size command */
 #define MR_IOC_SERIAL_SET_WR_DMA_BUFSZ  (0x02)                      /**< Set write DMA buffer size command */
 
 #define MR_IOC_SERIAL_GET_RD_DMA_BUFSZ  (-(0x01))                   /**< Get read DMA buffer size command */
 #define MR_IOC_SERIAL_GET_WR_DMA_BUFSZ  (-(0x02))                   /**< Get write DMA buffer size command */
+#ifdef MR_USING_SERIAL_DMA_TXQ
+#define MR_IOC_SERIAL_QUEUE_WR_DMA      (MR_IOC_ASYNC | (0x03))     /**< Queue write DMA request command */
+#endif /* MR_USING_SERIAL_DMA_TXQ */
+#ifdef MR_USING_SERIAL_DMA_CIRC
+#define MR_IOC_SERIAL_GET_RD_DMA_LOST   (-(0x03))                   /**< Get read DMA lost data size command */
+#endif /* MR_USING_SERIAL_DMA_CIRC */
 #endif /* MR_USING_SERIAL_DMA */
 
 /**
@@ -120,8 +171,28 @@ typedef uint8_t mr_serial_data_t;                                   /**< Serial
  */
 #define MR_ISR_SERIAL_RD_INT            (MR_ISR_RD | (0x01))        /**< Read interrupt event */
 #define MR_ISR_SERIAL_WR_INT            (MR_ISR_WR | (0x02))        /**< Write interrupt event */
-#define MR_ISR_SERIAL_RD_DMA            (MR_ISR_RD | (0x03))        /**< Read DMA interrupt event */
+#define MR_ISR_SERIAL_RD_DMA            (MR_ISR_RD | MR_ISR_ARG_SIZE | (0x03)) /**< Read DMA interrupt event */
 #define MR_ISR_SERIAL_WR_DMA            (MR_ISR_WR | (0x04))        /**< Write DMA interrupt event */
+#define MR_ISR_SERIAL_RD_DMA_POS        (MR_ISR_RD | MR_ISR_ARG_SIZE | (0x05)) /**< Read circular DMA position event */
+#define MR_ISR_SERIAL_WR_TC             (MR_ISR_WR | (0x06))        /**< Write transmit-complete event */
+
+#ifdef MR_USING_SERIAL_DMA_TXQ
+/**
+ * @brief Serial DMA transmit request structure.
+ *
+ * @note The buffer is owned by the serial until the completion callback, which is called in the interrupt. A small
+ *       request that is copied into a staging buffer is completed at once, the callback is called by the queue
+ *       command.
+ */
+struct mr_serial_tx
+{
+    struct mr_list list;                                            /**< Queue list */
+    const void *buf;                                                /**< Buffer (DMA accessible) */
+    size_t count;                                                   /**< Count */
+    ssize_t ret;                                                    /**< Result, the count or an error code */
+    void (*done)(struct mr_serial_tx *tx);                          /**< Completion callback */
+};
+#endif /* MR_USING_SERIAL_DMA_TXQ */
 
 /**
  * @brief Serial structure.
@@ -135,11 +206,33 @@ struct mr_serial
     struct mr_ringbuf wr_fifo;                                      /**< Write FIFO */
     size_t rd_bufsz;                                                /**< Read buffer size */
     size_t wr_bufsz;                                                /**< Write buffer size */
+#ifdef MR_USING_SERIAL_FRAME
+    struct mr_serial_frame_config frame;                            /**< Frame configuration */
+    size_t frame_num;                                               /**< Complete frames in the read FIFO */
+    size_t frame_pos;                                               /**< Offset of the incomplete frame */
+    size_t frame_scan;                                              /**< Offset scanned for the delimiter */
+#endif /* MR_USING_SERIAL_FRAME */
+#ifdef MR_USING_SERIAL_RS485
+    struct mr_serial_rs485_config rs485;                            /**< RS-485 configuration */
+    volatile int rs485_state;                                       /**< RS-485 DE state */
+#endif /* MR_USING_SERIAL_RS485 */
 #ifdef MR_USING_SERIAL_DMA
     uint8_t *dma_rd_buf;                                            /**< Read DMA buffer */
     uint8_t *dma_wr_buf;                                            /**< Write DMA buffer */
     size_t dma_rd_bufsz;                                            /**< Read DMA buffer size */
     size_t dma_wr_bufsz;                                            /**< Write DMA buffer size */
+#ifdef MR_USING_SERIAL_DMA_CIRC
+    int dma_rd_circ;                                                /**< Read DMA circular state */
+    size_t dma_rd_wpos;                                             /**< Read DMA write position */
+    size_t dma_rd_rpos;                                             /**< Read DMA read position */
+    volatile size_t dma_rd_in;                                      /**< Read DMA received data size */
+    size_t dma_rd_out;                                              /**< Read DMA consumed data size */
+    size_t dma_rd_lost;                                             /**< Read DMA lost data size */
+#endif /* MR_USING_SERIAL_DMA_CIRC */
+#ifdef MR_USING_SERIAL_DMA_TXQ
+    struct mr_list tx_list;                                         /**< DMA transmit queue */
+    struct mr_serial_tx tx_stage[2];                                /**< DMA transmit staging requests */
+#endif /* MR_USING_SERIAL_DMA_TXQ */
 #endif /* MR_USING_SERIAL_DMA */
     int nonblock_state;                                             /**< Nonblocking state */
 };
@@ -160,7 +253,20 @@ struct mr_serial_ops
     void (*stop_dma_tx)(struct mr_serial *serial);
     void (*start_dma_rx)(struct mr_serial *serial, uint8_t *buf, size_t count);
     void (*stop_dma_rx)(struct mr_serial *serial);
+#ifdef MR_USING_SERIAL_DMA_CIRC
+    /* Optional, the position is reported at least every half of the buffer, on half-transfer and transfer-complete */
+    void (*start_dma_rx_circ)(struct mr_serial *serial, uint8_t *buf, size_t count);
+#endif /* MR_USING_SERIAL_DMA_CIRC */
 #endif /* MR_USING_SERIAL_DMA */
+
+    /* Optional, drain or fill the hardware FIFO without waiting and return the count, used by the interrupt */
+    ssize_t (*read_burst)(struct mr_serial *serial, uint8_t *buf, size_t count);
+    ssize_t (*write_burst)(struct mr_serial *serial, const uint8_t *buf, size_t count);
+
+#ifdef MR_USING_SERIAL_RS485
+    /* Optional, return true when the last bit left the shift register, used by the polling write */
+    int (*is_tx_complete)(struct mr_serial *serial);
+#endif /* MR_USING_SERIAL_RS485 */
 };
 
 int mr_serial_register(struct mr_serial *serial, const char *path, struct mr_drv *drv);
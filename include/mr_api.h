@@ -30,17 +30,26 @@ void mr_interrupt_enable(void);
  */
 void mr_delay_us(uint32_t us);
 void mr_delay_ms(uint32_t ms);
+uint32_t mr_cycle_get(void);
 /** @} */
 
 /**
  * @addtogroup Memory
  * @{
  */
+int mr_heap_add_region(void *memory, size_t size, int flags, int priority);
 void *mr_malloc(size_t size);
+void *mr_malloc_ex(size_t size, int flags);
+void *mr_malloc_aligned(size_t size, size_t align, int flags);
 void mr_free(void *memory);
+void mr_free_aligned(void *memory);
 size_t mr_malloc_usable_size(void *memory);
 void *mr_calloc(size_t num, size_t size);
 void *mr_realloc(void *memory, size_t size);
+int mr_heap_slab_get_stats(size_t index, struct mr_heap_slab_stats *stats);
+const char *mr_heap_set_tag(const char *tag);
+int mr_heap_get_stats(struct mr_heap_stats *stats);
+int mr_heap_get_tag_stats(size_t index, struct mr_heap_tag_stats *stats);
 /** @} */
 
 /**
@@ -76,6 +85,14 @@ size_t mr_ringbuf_push(struct mr_ringbuf *ringbuf, uint8_t data);
 size_t mr_ringbuf_push_force(struct mr_ringbuf *ringbuf, uint8_t data);
 size_t mr_ringbuf_write(struct mr_ringbuf *ringbuf, const void *buffer, size_t size);
 size_t mr_ringbuf_write_force(struct mr_ringbuf *ringbuf, const void *buffer, size_t size);
+size_t mr_ringbuf_read_peek(struct mr_ringbuf *ringbuf, struct mr_ringbuf_span *span, size_t size);
+size_t mr_ringbuf_read_consume(struct mr_ringbuf *ringbuf, size_t size);
+size_t mr_ringbuf_write_reserve(struct mr_ringbuf *ringbuf, struct mr_ringbuf_span *span, size_t size);
+size_t mr_ringbuf_write_commit(struct mr_ringbuf *ringbuf, size_t size);
+size_t mr_ringbuf_get_record_size(struct mr_ringbuf *ringbuf);
+size_t mr_ringbuf_read_record(struct mr_ringbuf *ringbuf, void *buffer, size_t size);
+size_t mr_ringbuf_write_record(struct mr_ringbuf *ringbuf, const void *buffer, size_t size);
+size_t mr_ringbuf_write_record_force(struct mr_ringbuf *ringbuf, const void *buffer, size_t size);
 /** @} */
 
 /**
@@ -89,6 +106,16 @@ struct mr_avl *mr_avl_find(struct mr_avl *tree, uint32_t value);
 size_t mr_avl_get_length(struct mr_avl *tree);
 /** @} */
 
+/**
+ * @addtogroup Trace
+ * @{
+ */
+void mr_trace(uint32_t type, uint32_t start, const void *obj, int arg, int ret);
+int mr_trace_get_event(size_t index, struct mr_trace_event *event);
+int mr_trace_set_enable(int enable);
+void mr_trace_clear(void);
+/** @} */
+
 /**
  * @addtogroup Device
  * @{
@@ -104,7 +131,15 @@ int mr_dev_open(const char *path, int flags);
 int mr_dev_close(int desc);
 ssize_t mr_dev_read(int desc, void *buf, size_t count);
 ssize_t mr_dev_write(int desc, const void *buf, size_t count);
+ssize_t mr_dev_readv(int desc, const struct mr_dev_iovec *iov, size_t iovcnt);
+ssize_t mr_dev_writev(int desc, const struct mr_dev_iovec *iov, size_t iovcnt);
 int mr_dev_ioctl(int desc, int cmd, void *args);
+int mr_dev_aio_read(int desc, struct mr_dev_aio *aio);
+int mr_dev_aio_write(int desc, struct mr_dev_aio *aio);
+size_t mr_dev_aio_reap(struct mr_dev_aio **aio, size_t num);
+int mr_dev_poll(struct mr_dev_pollfd *fds, size_t num);
+size_t mr_dev_dispatch(void);
+int mr_dev_get_dispatch_stats(struct mr_dev_dispatch_stats *stats);
 /** @} */
 
 #ifdef __cplusplus
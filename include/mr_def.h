@@ -123,14 +123,65 @@ typedef void (*mr_init_fn_t)(void);                                 /**< Auto in
  * @{
  */
 
+/**
+ * @brief Heap region flags.
+ */
+#define MR_HEAP_DMA                     (0x01)                      /**< DMA-capable memory */
+#define MR_HEAP_FAST                    (0x02)                      /**< Zero-wait-state memory */
+#define MR_HEAP_BULK                    (0x04)                      /**< Large and slow memory */
+
 /**
  * @brief Heap block structure.
  */
 struct mr_heap_block
 {
     struct mr_heap_block *next;                                     /**< Point to next block */
+#ifdef MR_USING_HEAP_TLSF
+    struct mr_heap_block *prev;                                     /**< Point to previous physical block */
+#endif /* MR_USING_HEAP_TLSF */
     uint32_t size: 31;                                              /**< Size of this block */
     uint32_t allocated: 1;                                          /**< Allocated flag */
+#ifdef MR_USING_HEAP_STATS
+    uint32_t tag;                                                   /**< Tag index */
+#endif /* MR_USING_HEAP_STATS */
+};
+
+/**
+ * @brief Heap slab statistics structure.
+ */
+struct mr_heap_slab_stats
+{
+    size_t size;                                                    /**< Object size */
+    size_t total;                                                   /**< Total objects */
+    size_t used;                                                    /**< Used objects */
+    size_t peak;                                                    /**< Peak used objects */
+    size_t fails;                                                   /**< Refill failures */
+};
+
+/**
+ * @brief Heap statistics structure.
+ */
+struct mr_heap_stats
+{
+    size_t total;                                                   /**< Total bytes */
+    size_t used;                                                    /**< Used bytes */
+    size_t peak;                                                    /**< Peak used bytes */
+    size_t free;                                                    /**< Free bytes */
+    size_t free_blocks;                                             /**< Free blocks */
+    size_t max_free;                                                /**< Largest free block */
+    size_t fails;                                                   /**< Allocation failures */
+    uint32_t frag;                                                  /**< Fragmentation (%) */
+};
+
+/**
+ * @brief Heap tag statistics structure.
+ */
+struct mr_heap_tag_stats
+{
+    const char *name;                                               /**< Tag name */
+    size_t used;                                                    /**< Used bytes */
+    size_t peak;                                                    /**< Peak used bytes */
+    size_t count;                                                   /**< Allocations */
 };
 /** @} */
 
@@ -161,11 +212,22 @@ struct mr_ringbuf
 {
     uint8_t *buffer;                                                /**< Buffer pool */
     size_t size;                                                    /**< Buffer pool size */
-    uint32_t read_mirror: 1;                                        /**< Read mirror flag */
-    uint32_t write_mirror: 1;                                       /**< Write mirror flag */
-    uint32_t _reserved: 30;                                         /**< Reserved */
-    size_t read_index;                                              /**< Read index */
-    size_t write_index;                                             /**< Write index */
+    size_t read_index;                                              /**< Read index (written by the consumer) */
+    size_t write_index;                                             /**< Write index (written by the producer) */
+};
+
+/**
+ * @brief Ring buffer record head size.
+ */
+#define MR_RINGBUF_RECORD_HEAD          (2)                         /**< Size of the record size prefix */
+
+/**
+ * @brief Ring buffer span structure.
+ */
+struct mr_ringbuf_span
+{
+    uint8_t *buffer;                                                /**< Span buffer */
+    size_t size;                                                    /**< Span size */
 };
 /** @} */
 
@@ -186,6 +248,34 @@ struct mr_avl
 };
 /** @} */
 
+/**
+ * @addtogroup Trace
+ * @{
+ */
+#define MR_TRACE_DEV_OPEN               (1)                         /**< Device open event */
+#define MR_TRACE_DEV_CLOSE              (2)                         /**< Device close event */
+#define MR_TRACE_DEV_READ               (3)                         /**< Device read event */
+#define MR_TRACE_DEV_WRITE              (4)                         /**< Device write event */
+#define MR_TRACE_DEV_IOCTL              (5)                         /**< Device ioctl event */
+#define MR_TRACE_DEV_ISR                (6)                         /**< Device interrupt event */
+#define MR_TRACE_DEV_LOCK               (7)                         /**< Device lock contention event */
+#define MR_TRACE_MALLOC                 (8)                         /**< Memory allocation event */
+#define MR_TRACE_FREE                   (9)                         /**< Memory free event */
+
+/**
+ * @brief Trace event structure.
+ */
+struct mr_trace_event
+{
+    uint32_t time;                                                  /**< Start cycles */
+    uint32_t cycles;                                                /**< Cycles */
+    uint32_t obj;                                                   /**< Object (device or memory) address */
+    int32_t arg;                                                    /**< Argument */
+    int32_t ret;                                                    /**< Result */
+    uint32_t type;                                                  /**< Type */
+};
+/** @} */
+
 /**
  * @addtogroup Device
  * @{
@@ -195,12 +285,13 @@ struct mr_avl
 #define MR_SYNC                         (0)                         /**< Synchronous */
 #define MR_ASYNC                        (1)                         /**< Asynchronous */
 
-/* [31:24] are for lock, [23:0] reserved */
+/* [31:24] are for lock, [23:0] are for the holders counts of the lock device */
 #define MR_LOCK_RD                      (0x01 << 24)                /**< Read lock */
 #define MR_LOCK_WR                      (0x02 << 24)                /**< Write lock */
 #define MR_LOCK_RDWR                    (0x03 << 24)                /**< Read/write lock */
 #define MR_LOCK_NONBLOCK                (0x04 << 24)                /**< Non-blocking lock */
 #define MR_LOCK_SLEEP                   (0x08 << 24)                /**< Sleep lock */
+#define MR_LOCK_CTL                     (0x10 << 24)                /**< Control lock */
 
 /* [31:24] are for basic flags, [23:0] can define user flags */
 #define MR_O_CLOSED                     (0)                         /**< Closed flag */
@@ -219,6 +310,9 @@ struct mr_avl
 #define MR_IOC_SWBSZ                    (0x06 << 24)                /**< Set write buffer size command */
 #define MR_IOC_CRBD                     (0x07 << 24)                /**< Clear read buffer data command */
 #define MR_IOC_CWBD                     (0x08 << 24)                /**< Clear write buffer data command */
+#define MR_IOC_CSTAT                    (0x09 << 24)                /**< Clear statistics command */
+#define MR_IOC_CLOCK                    (0x0a << 24)                /**< Clear lock contention count command */
+#define MR_IOC_ASYNC                    (0x40 << 24)                /**< Set flag, not waiting for async writes */
 
 #define MR_IOC_GPOS                     (-(0x01 << 24))             /**< Get position command */
 #define MR_IOC_GRCB                     (-(0x02 << 24))             /**< Get read callback command */
@@ -228,11 +322,18 @@ struct mr_avl
 #define MR_IOC_GWBSZ                    (-(0x06 << 24))             /**< Get write buffer size command */
 #define MR_IOC_GRBDSZ                   (-(0x07 << 24))             /**< Get read buffer data size command */
 #define MR_IOC_GWBDSZ                   (-(0x08 << 24))             /**< Get write buffer data size command */
+#define MR_IOC_GSTAT                    (-(0x09 << 24))             /**< Get statistics command */
+#define MR_IOC_GLOCK                    (-(0x0a << 24))             /**< Get lock contention count command */
 
 /* [31:24] are for interrupt flags, [23:0] can define user flags */
 #define MR_ISR_RD                       (0x01 << 24)                /**< Read interrupt event */
 #define MR_ISR_WR                       (0x02 << 24)                /**< Write interrupt event */
 #define MR_ISR_MASK                     (0x7f << 24)                /**< Interrupt event mask */
+#define MR_ISR_ARG_SIZE                 (0x01 << 16)                /**< Event argument is a size_t (not an int) */
+
+#define MR_POLL_RD                      (0x01)                      /**< Readable poll event */
+#define MR_POLL_WR                      (0x02)                      /**< Writable poll event */
+#define MR_POLL_ERR                     (0x04)                      /**< Error poll event */
 
 /**
  * @brief Driver structure.
@@ -263,6 +364,15 @@ enum mr_dev_type
 
 struct mr_dev;
 
+/**
+ * @brief Device I/O vector structure.
+ */
+struct mr_dev_iovec
+{
+    void *buf;                                                      /**< Buffer */
+    size_t count;                                                   /**< Count */
+};
+
 /**
  * @brief Device operations structure.
  */
@@ -274,6 +384,8 @@ struct mr_dev_ops
     ssize_t (*write)(struct mr_dev *dev, const void *buf, size_t count);
     int (*ioctl)(struct mr_dev *dev, int cmd, void *args);
     ssize_t (*isr)(struct mr_dev *dev, int event, void *args);
+    ssize_t (*readv)(struct mr_dev *dev, const struct mr_dev_iovec *iov, size_t iovcnt);
+    ssize_t (*writev)(struct mr_dev *dev, const struct mr_dev_iovec *iov, size_t iovcnt);
 };
 
 /**
@@ -286,6 +398,38 @@ struct mr_dev_call
     void (*fn)(int desc, void *args);                               /**< Callback function */
 };
 
+#ifdef MR_USING_DEV_STATS
+/**
+ * @brief Device operation statistics structure.
+ */
+struct mr_dev_op_stats
+{
+#ifndef MR_CFG_DEV_STATS_HIST_NUM
+#define MR_CFG_DEV_STATS_HIST_NUM       (16)
+#endif /* MR_CFG_DEV_STATS_HIST_NUM */
+    uint32_t count;                                                 /**< Operations */
+    uint32_t errors;                                                /**< Operations failed */
+    uint32_t busy;                                                  /**< Operations failed as busy */
+    uint64_t bytes;                                                 /**< Bytes */
+    uint32_t max_cycles;                                            /**< Max cycles of an operation */
+    uint32_t hist[MR_CFG_DEV_STATS_HIST_NUM];                       /**< Log2 histogram of the cycles */
+};
+
+/**
+ * @brief Device statistics structure.
+ */
+struct mr_dev_stats
+{
+    struct mr_dev_op_stats rd;                                      /**< Read statistics */
+    struct mr_dev_op_stats wr;                                      /**< Write statistics */
+    struct mr_dev_op_stats ioctl;                                   /**< Ioctl statistics */
+    struct mr_dev_op_stats isr;                                     /**< Interrupt statistics */
+    struct mr_dev_op_stats call;                                    /**< Callback statistics */
+    uint32_t rd_events;                                             /**< Read interrupt events */
+    uint32_t wr_events;                                             /**< Write interrupt events */
+};
+#endif /* MR_USING_DEV_STATS */
+
 /**
  * @brief Device structure.
  */
@@ -301,32 +445,118 @@ struct mr_dev
     void *parent;                                                   /**< Parent device */
     struct mr_list list;                                            /**< Same level device list */
     struct mr_list clist;                                           /**< Child device list */
+#ifdef MR_USING_DEV_HASH
+    struct mr_dev *hash_next;                                       /**< Next device in the hash bucket */
+    uint32_t hash;                                                  /**< Path hash */
+#endif /* MR_USING_DEV_HASH */
 
     size_t ref_count;                                               /**< Reference count */
 #ifdef MR_USING_RDWR_CTL
     volatile uint32_t lock;                                         /**< Lock flags */
+    struct mr_dev *lock_dev;                                        /**< Device holding the shared lock (top device) */
+    uint32_t lock_busy;                                             /**< Lock contention count */
 #endif /* MR_USING_RDWR_CTL */
     int sync;                                                       /**< Sync flag */
     int position;                                                   /**< Position */
+#ifdef MR_USING_DEV_POLL
+    volatile uint32_t ready;                                        /**< Ready poll events */
+#endif /* MR_USING_DEV_POLL */
 
     struct mr_list rd_call_list;                                    /**< Read callback list */
     struct mr_list wr_call_list;                                    /**< Write callback list */
+#ifdef MR_USING_DEV_AIO
+    struct mr_list rd_aio_list;                                     /**< Asynchronous read request list */
+    struct mr_list wr_aio_list;                                     /**< Asynchronous write request list */
+    volatile uint32_t aio_run;                                      /**< Asynchronous request run flags */
+#endif /* MR_USING_DEV_AIO */
+#ifdef MR_USING_DEV_STATS
+    struct mr_dev_stats stats;                                      /**< Statistics */
+#endif /* MR_USING_DEV_STATS */
 
     const struct mr_dev_ops *ops;                                   /**< Operations */
     const struct mr_drv *drv;                                       /**< Driver */
 };
 
+#ifdef MR_USING_DEV_STATIC
+#ifdef MR_USING_DEV_POLL
+#define _MR_DEV_POLL_INIT               .ready = (MR_POLL_RD | MR_POLL_WR),
+#else
+#define _MR_DEV_POLL_INIT
+#endif /* MR_USING_DEV_POLL */
+#ifdef MR_USING_RDWR_CTL
+#define _MR_DEV_LOCK_INIT(dev)          .lock_dev = &(dev),
+#else
+#define _MR_DEV_LOCK_INIT(dev)
+#endif /* MR_USING_RDWR_CTL */
+#ifdef MR_USING_DEV_AIO
+#define _MR_DEV_AIO_INIT(dev) \
+    .rd_aio_list = MR_LIST_INIT((dev).rd_aio_list), .wr_aio_list = MR_LIST_INIT((dev).wr_aio_list),
+#else
+#define _MR_DEV_AIO_INIT(dev)
+#endif /* MR_USING_DEV_AIO */
+/**
+ * @brief Initializer of a static device, the parent is a static device or MR_NULL for the root device.
+ */
+#define MR_DEV_STATIC_INIT(dev, _name, _parent, _type, _flags, _ops, _drv) \
+    {.magic = MR_MAGIC_NUMBER, .name = _name, .type = (_type), .flags = (_flags), .parent = (_parent), \
+     .list = MR_LIST_INIT((dev).list), .clist = MR_LIST_INIT((dev).clist), _MR_DEV_LOCK_INIT(dev) \
+     .sync = MR_SYNC, .position = -1, _MR_DEV_POLL_INIT .rd_call_list = MR_LIST_INIT((dev).rd_call_list), \
+     .wr_call_list = MR_LIST_INIT((dev).wr_call_list), _MR_DEV_AIO_INIT(dev) .ops = (_ops), .drv = (_drv)}
+/**
+ * @brief Exports a static device, it is linked into the device tree when the device tree is first used.
+ */
+#define MR_DEV_STATIC_EXPORT(name, dev) \
+    MR_USED struct mr_dev *const _mr_dev_static_##name MR_SECTION("mr_dev_static.1") = (dev)
+#endif /* MR_USING_DEV_STATIC */
+
 /**
  * @brief Device descriptor structure.
  */
 struct mr_dev_desc
 {
+    int id;                                                         /**< Descriptor (index and generation) */
+    int next;                                                       /**< Next free descriptor index */
     struct mr_dev *dev;                                             /**< Device */
     int flags;                                                      /**< Open flags */
     int position;                                                   /**< Current position */
     struct mr_dev_call rd_call;                                     /**< Read callback */
     struct mr_dev_call wr_call;                                     /**< Write callback */
 };
+
+/**
+ * @brief Device asynchronous I/O request structure.
+ */
+struct mr_dev_aio
+{
+    struct mr_list list;                                            /**< Request list */
+    int desc;                                                       /**< Descriptor */
+    void *buf;                                                      /**< Buffer */
+    size_t count;                                                   /**< Count */
+    void *token;                                                    /**< User token */
+    ssize_t ret;                                                    /**< Result */
+};
+
+/**
+ * @brief Device deferred dispatch statistics structure.
+ */
+struct mr_dev_dispatch_stats
+{
+    size_t queued;                                                  /**< Queued events */
+    size_t dispatched;                                              /**< Dispatched events */
+    size_t pending;                                                 /**< Pending events */
+    size_t peak;                                                    /**< Peak pending events */
+    size_t lost;                                                    /**< Events lost on overflow */
+};
+
+/**
+ * @brief Device poll structure.
+ */
+struct mr_dev_pollfd
+{
+    int desc;                                                       /**< Descriptor */
+    int events;                                                     /**< Requested events */
+    int revents;                                                    /**< Returned events */
+};
 /** @} */
 
 #ifdef __cplusplus
@@ -15,16 +15,79 @@ static struct mr_dev root_dev = {.name = "dev", .type = MR_DEV_TYPE_ROOT, .paren
 #define MR_CFG_DESC_NUM                 (32)
 #endif /* MR_CFG_DESC_NUM */
 static struct mr_dev_desc desc_map[MR_CFG_DESC_NUM] = {0};          /**< Device descriptor map */
-
-#define DESC_OF(desc)                   (desc_map[(desc)])          /**< Descriptor of the device */
+#ifdef MR_USING_DESC_GROW
+#ifndef MR_CFG_DESC_GROW_NUM
+#define MR_CFG_DESC_GROW_NUM            (4)
+#endif /* MR_CFG_DESC_GROW_NUM */
+static struct mr_dev_desc *desc_grow_map[MR_CFG_DESC_GROW_NUM] = {0}; /**< Grown device descriptor maps */
+#define DESC_MAX_NUM                    (MR_CFG_DESC_NUM * (MR_CFG_DESC_GROW_NUM + 1))
+#else
+#define DESC_MAX_NUM                    (MR_CFG_DESC_NUM)
+#endif /* MR_USING_DESC_GROW */
+#ifdef MR_USING_DEV_AIO
+static struct mr_list dev_aio_done_list = MR_LIST_INIT(dev_aio_done_list); /**< Completed asynchronous I/O list */
+#endif /* MR_USING_DEV_AIO */
+static int desc_free_head = -1;                                     /**< Free descriptor list head */
+static size_t desc_used_num = 0;                                    /**< Number of the ever used descriptors */
+
+#ifdef MR_USING_DEV_DEFER
+#ifndef MR_CFG_DEV_DEFER_NUM
+#define MR_CFG_DEV_DEFER_NUM            (32)
+#endif /* MR_CFG_DEV_DEFER_NUM */
+#if (MR_CFG_DEV_DEFER_NUM & (MR_CFG_DEV_DEFER_NUM - 1)) != 0
+#error "MR_CFG_DEV_DEFER_NUM must be a power of 2"
+#endif /* (MR_CFG_DEV_DEFER_NUM & (MR_CFG_DEV_DEFER_NUM - 1)) != 0 */
+/* Each event keeps its lap: the position it is free for when even and the position it is filled for when odd */
+static struct dev_defer_event
+{
+    uint32_t lap;                                                   /**< Lap of the event */
+    struct mr_dev *dev;                                             /**< Device */
+    int event;                                                      /**< Interrupt event */
+    size_t value;                                                   /**< Copy of the event argument */
+    int has_value;                                                  /**< Whether the event has the argument */
+} dev_defer_queue[MR_CFG_DEV_DEFER_NUM] = {0};                    /**< Deferred event queue */
+static uint32_t dev_defer_tail = 0;                                 /**< Deferred event queue tail (interrupts) */
+static uint32_t dev_defer_head = 0;                                 /**< Deferred event queue head (dispatch) */
+static struct mr_dev_dispatch_stats dev_defer_stats = {0};          /**< Deferred event statistics */
+#endif /* MR_USING_DEV_DEFER */
+
+#ifdef MR_USING_DEV_STATIC
+MR_USED static struct mr_dev *const dev_static_start MR_SECTION("mr_dev_static.0") = MR_NULL;
+MR_USED static struct mr_dev *const dev_static_end MR_SECTION("mr_dev_static.2.end") = MR_NULL;
+static int dev_static_is_linked = MR_FALSE;                         /**< Whether the static devices are linked */
+#endif /* MR_USING_DEV_STATIC */
+
+#ifdef MR_USING_DEV_HASH
+#ifndef MR_CFG_DEV_HASH_NUM
+#define MR_CFG_DEV_HASH_NUM             (16)
+#endif /* MR_CFG_DEV_HASH_NUM */
+static struct mr_dev *dev_hash_table[MR_CFG_DEV_HASH_NUM] = {0};  /**< Device path hash table */
+#endif /* MR_USING_DEV_HASH */
+
+/* The descriptor is the map index in the low bits and the generation of the map entry in the high bits */
+#define DESC_INDEX_BITS                 (16)
+#define DESC_INDEX(desc)                ((size_t)(desc) & ((1 << DESC_INDEX_BITS) - 1))
+#define DESC_GEN_MASK                   (0x7fff)
+#define DESC_OF(desc)                   (*desc_get(DESC_INDEX(desc))) /**< Descriptor of the device */
 /* Check if the descriptor is valid */
-#define DESC_IS_VALID(desc)             (((desc) >= 0 && (desc) < MR_CFG_DESC_NUM) && ((DESC_OF(desc).dev) != MR_NULL))
+#define DESC_IS_VALID(desc)             (((desc) >= 0 && DESC_INDEX(desc) < desc_used_num) && \
+                                         (DESC_OF(desc).id == (desc)) && ((DESC_OF(desc).dev) != MR_NULL))
 #ifdef MR_USING_DESC_CHECK
 #define MR_DESC_CHECK(desc)             if (DESC_IS_VALID(desc) == MR_FALSE) { return MR_EINVAL; }
 #else
 #define MR_DESC_CHECK(desc)
 #endif /* MR_USING_DESC_CHECK */
 
+MR_INLINE struct mr_dev_desc *desc_get(size_t index)
+{
+#ifdef MR_USING_DESC_GROW
+    if (index >= MR_CFG_DESC_NUM) {
+        return &desc_grow_map[(index / MR_CFG_DESC_NUM) - 1][index % MR_CFG_DESC_NUM];
+    }
+#endif /* MR_USING_DESC_GROW */
+    return &desc_map[index];
+}
+
 MR_INLINE int dev_is_root(struct mr_dev *dev)
 {
     return dev->type == MR_DEV_TYPE_ROOT;
@@ -82,6 +145,7 @@ static int dev_register_by_path(struct mr_dev *parent, struct mr_dev *dev, const
     }
 }
 
+#ifndef MR_USING_DEV_HASH
 static struct mr_dev *dev_find_by_path(struct mr_dev *parent, const char *path)
 {
     if (path[0] == '/') {
@@ -109,38 +173,180 @@ static struct mr_dev *dev_find_by_path(struct mr_dev *parent, const char *path)
         return dev_find_child(parent, path);
     }
 }
+#endif /* MR_USING_DEV_HASH */
 
-#ifdef MR_USING_RDWR_CTL
-static int dev_lock_take(struct mr_dev *dev, uint32_t take, uint32_t set)
+#ifdef MR_USING_DEV_HASH
+MR_INLINE uint32_t dev_hash_path(const char *path)
+{
+    uint32_t hash = 2166136261u;
+
+    if (*path == '/') {
+        path++;
+    }
+
+    /* FNV-1a over the path, each name is cut to the max length as the device tree does */
+    for (size_t len = 0; *path != '\0'; path++) {
+        if (*path == '/') {
+            len = 0;
+        } else if (len++ >= MR_CFG_DEV_NAME_LEN) {
+            continue;
+        }
+        hash = (hash ^ (uint8_t)*path) * 16777619u;
+    }
+    return hash;
+}
+
+MR_INLINE int dev_name_is_match(struct mr_dev *dev, const char *name, size_t len)
+{
+    if (len >= MR_CFG_DEV_NAME_LEN) {
+        return strncmp(name, dev->name, MR_CFG_DEV_NAME_LEN) == 0;
+    }
+    return (strncmp(name, dev->name, len) == 0) && (dev->name[len] == '\0');
+}
+
+MR_INLINE int dev_path_is_match(struct mr_dev *dev, const char *path)
+{
+    size_t len = strlen(path);
+
+    /* Match the names from the last one up to the root device */
+    while (dev_is_root(dev) != MR_TRUE) {
+        size_t start = len;
+
+        while ((start > 0) && (path[start - 1] != '/')) {
+            start--;
+        }
+        if ((start == len) || (dev_name_is_match(dev, &path[start], len - start) != MR_TRUE)) {
+            return MR_FALSE;
+        }
+        len = (start > 0) ? (start - 1) : 0;
+        dev = dev->parent;
+    }
+    return len == 0;
+}
+
+static uint32_t dev_hash_dev(struct mr_dev *dev)
 {
-    /* Continue iterating until reach the root device */
+    uint32_t hash = 2166136261u;
+
+    /* The same hash as the path of the device, continued from the path of the parent */
     if (dev_is_root(dev->parent) != MR_TRUE) {
-        int ret = dev_lock_take(dev->parent, take, set);
-        if (ret < 0) {
-            return ret;
+        hash = (dev_hash_dev(dev->parent) ^ (uint8_t)'/') * 16777619u;
+    }
+    for (size_t i = 0; (i < MR_CFG_DEV_NAME_LEN) && (dev->name[i] != '\0'); i++) {
+        hash = (hash ^ (uint8_t)dev->name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+MR_INLINE void dev_hash_insert(struct mr_dev *dev)
+{
+    dev->hash = dev_hash_dev(dev);
+    dev->hash_next = dev_hash_table[dev->hash % MR_CFG_DEV_HASH_NUM];
+    dev_hash_table[dev->hash % MR_CFG_DEV_HASH_NUM] = dev;
+}
+
+MR_INLINE struct mr_dev *dev_hash_find(const char *path)
+{
+    uint32_t hash = dev_hash_path(path);
+
+    for (struct mr_dev *dev = dev_hash_table[hash % MR_CFG_DEV_HASH_NUM]; dev != MR_NULL; dev = dev->hash_next) {
+        if ((dev->hash == hash) && (dev_path_is_match(dev, path) == MR_TRUE)) {
+            return dev;
         }
     }
+    return MR_NULL;
+}
+#endif /* MR_USING_DEV_HASH */
 
-    if (dev->lock & take) {
+#ifdef MR_USING_RDWR_CTL
+#define DEV_LOCK_SHARED                 (0x00000fff)                /* Shared holders count mask */
+#define DEV_LOCK_FLIGHT                 (0x00fff000)                /* Asynchronous writes in flight count mask */
+
+MR_INLINE uint32_t dev_lock_count(uint32_t flags)
+{
+    /* The asynchronous write in flight is counted apart, only the control that waits for it checks the count */
+    return (flags & MR_LOCK_NONBLOCK) ? 0x00001000 : 0x00000001;
+}
+
+/*
+ * The lock flags of an operation are only held by the device itself, the top device (the ancestor under the root,
+ * resolved when the device is opened) counts the holders of its whole subtree as shared, so that children do not
+ * exclude each other and only the control of the top device is exclusive.
+ */
+static int dev_lock_take(struct mr_dev *dev, uint32_t take, uint32_t set)
+{
+    struct mr_dev *lock_dev = dev->lock_dev;
+
+    /* Check the own flags, the top device under control and the exclusive control of the top device */
+    if ((dev->lock & take) ||
+        (lock_dev->lock & take & (MR_LOCK_CTL | MR_LOCK_SLEEP)) ||
+        ((lock_dev == dev) && (set & MR_LOCK_CTL) &&
+         (dev->lock & (DEV_LOCK_SHARED | ((take & MR_LOCK_NONBLOCK) ? DEV_LOCK_FLIGHT : 0))))) {
+        dev->lock_busy++;
+#ifdef MR_USING_TRACE
+        mr_trace(MR_TRACE_DEV_LOCK, mr_cycle_get(), dev, (int)take, (int)lock_dev->lock);
+#endif /* MR_USING_TRACE */
         return MR_EBUSY;
     }
+
+    /* Hold the top device as shared, unless it is the exclusive control of itself */
+    if ((lock_dev != dev) || ((set & MR_LOCK_CTL) == 0)) {
+        lock_dev->lock += dev_lock_count(set);
+    }
     MR_BIT_SET(dev->lock, set);
     return MR_EOK;
 }
 
 static void dev_lock_release(struct mr_dev *dev, uint32_t release)
 {
-    /* Continue iterating until reach the root device */
-    if (dev_is_root(dev->parent) != MR_TRUE) {
-        dev_lock_release(dev->parent, release);
-    }
+    struct mr_dev *lock_dev = dev->lock_dev;
 
+    if ((lock_dev != dev) || ((release & MR_LOCK_CTL) == 0)) {
+        lock_dev->lock -= dev_lock_count(release);
+    }
     MR_BIT_CLR(dev->lock, release);
 }
 #endif /* MR_USING_RDWR_CTL */
 
+#ifdef MR_USING_DEV_STATIC
+static void dev_static_link(void)
+{
+    mr_interrupt_disable();
+    if (dev_static_is_linked == MR_FALSE) {
+        /* Resolve the root parents first, the link order does not put a parent before its children */
+        for (struct mr_dev *const *dev = &dev_static_start + 1; dev < &dev_static_end; dev++) {
+            if ((*dev)->parent == MR_NULL) {
+                (*dev)->parent = &root_dev;
+            }
+        }
+
+        /* Link the static devices into their parents, the rest of the fields are initialized at compile time */
+        for (struct mr_dev *const *dev = &dev_static_start + 1; dev < &dev_static_end; dev++) {
+            struct mr_dev *parent = (struct mr_dev *)(*dev)->parent;
+
+            /* A duplicate name is not linked (the first one wins), as the registration refuses it */
+            if (dev_find_child(parent, (*dev)->name) != MR_NULL) {
+                continue;
+            }
+            mr_list_insert_before(&parent->clist, &(*dev)->list);
+#ifdef MR_USING_DEV_HASH
+            dev_hash_insert(*dev);
+#endif /* MR_USING_DEV_HASH */
+        }
+        dev_static_is_linked = MR_TRUE;
+    }
+    mr_interrupt_enable();
+}
+#endif /* MR_USING_DEV_STATIC */
+
 MR_INLINE struct mr_dev *dev_find(const char *path)
 {
+#ifdef MR_USING_DEV_STATIC
+    if (dev_static_is_linked == MR_FALSE) {
+        dev_static_link();
+    }
+#endif /* MR_USING_DEV_STATIC */
+
     /* Check whether the path is absolute */
     if (*path == '/') {
         path++;
@@ -153,12 +359,23 @@ MR_INLINE struct mr_dev *dev_find(const char *path)
         path += MR_BOUND(next_slash - path, 0, MR_CFG_DEV_NAME_LEN);
     }
 
+#ifdef MR_USING_DEV_HASH
+    /* Find the device from the hash table */
+    return dev_hash_find(path);
+#else
     /* Find the device from the root device */
     return dev_find_by_path(&root_dev, path);
+#endif /* MR_USING_DEV_HASH */
 }
 
 MR_INLINE int dev_register(struct mr_dev *dev, const char *path)
 {
+#ifdef MR_USING_DEV_STATIC
+    if (dev_static_is_linked == MR_FALSE) {
+        dev_static_link();
+    }
+#endif /* MR_USING_DEV_STATIC */
+
     /* Check whether the path is absolute */
     if (*path == '/') {
         path++;
@@ -174,6 +391,11 @@ MR_INLINE int dev_register(struct mr_dev *dev, const char *path)
     /* Register the device with the root device */
     mr_interrupt_disable();
     int ret = dev_register_by_path(&root_dev, dev, path);
+#ifdef MR_USING_DEV_HASH
+    if (ret == MR_EOK) {
+        dev_hash_insert(dev);
+    }
+#endif /* MR_USING_DEV_HASH */
     mr_interrupt_enable();
     return ret;
 }
@@ -196,9 +418,20 @@ static int dev_open(struct mr_dev *dev, int flags)
             }
         }
 
+#ifdef MR_USING_RDWR_CTL
+        /* Resolve the top device once, the I/O does not need to walk to the root */
+        dev->lock_dev = (dev_is_root(dev->parent) == MR_TRUE) ? dev : ((struct mr_dev *)dev->parent)->lock_dev;
+#endif /* MR_USING_RDWR_CTL */
+
         /* Open the device */
         if (dev->ops->open != MR_NULL) {
+#ifdef MR_USING_HEAP_STATS
+            const char *tag = mr_heap_set_tag(dev->name);
             int ret = dev->ops->open(dev);
+            mr_heap_set_tag(tag);
+#else
+            int ret = dev->ops->open(dev);
+#endif /* MR_USING_HEAP_STATS */
             if (ret < 0) {
                 return ret;
             }
@@ -233,93 +466,361 @@ static int dev_close(struct mr_dev *dev)
     return MR_EOK;
 }
 
-MR_INLINE ssize_t dev_read(struct mr_dev *dev, int position, int sync, void *buf, size_t count)
+#ifdef MR_USING_DEV_POLL
+MR_INLINE void dev_poll_set(struct mr_dev *dev, uint32_t events)
 {
-#ifdef MR_USING_RDWR_CTL
-    do {
-        mr_interrupt_disable();
-        int ret = dev_lock_take(dev, (MR_LOCK_RD | MR_LOCK_SLEEP), MR_LOCK_RD);
-        if (ret < 0) {
-            mr_interrupt_enable();
-            return ret;
+    mr_interrupt_disable();
+    MR_BIT_SET(dev->ready, events);
+    mr_interrupt_enable();
+}
+
+MR_INLINE void dev_poll_clear(struct mr_dev *dev, uint32_t events)
+{
+    mr_interrupt_disable();
+    MR_BIT_CLR(dev->ready, events);
+    mr_interrupt_enable();
+}
+#endif /* MR_USING_DEV_POLL */
+
+#ifdef MR_USING_DEV_STATS
+static void dev_stats_update(struct mr_dev_op_stats *stats, ssize_t ret, uint32_t start)
+{
+    uint32_t cycles = mr_cycle_get() - start;
+    size_t index = 0;
+
+    stats->count++;
+    if (ret < 0) {
+        stats->errors++;
+        if (ret == MR_EBUSY) {
+            stats->busy++;
         }
-        mr_interrupt_enable();
-    } while (0);
+    } else {
+        stats->bytes += (uint64_t)ret;
+    }
+
+    /* The bucket n counts the operations of [2^(n-1), 2^n) cycles, the last one counts the rest */
+#if defined(__GNUC__)
+    index = (cycles != 0) ? (size_t)(32 - __builtin_clz(cycles)) : 0;
+#else
+    while ((index < 32) && ((cycles >> index) != 0)) {
+        index++;
+    }
+#endif /* defined(__GNUC__) */
+    stats->hist[MR_MIN(index, (size_t)(MR_CFG_DEV_STATS_HIST_NUM - 1))]++;
+    stats->max_cycles = MR_MAX(stats->max_cycles, cycles);
+}
+#endif /* MR_USING_DEV_STATS */
+
+#if defined(MR_USING_DEV_STATS) || defined(MR_USING_TRACE)
+#define DEV_OP_START()                  (mr_cycle_get())
+#else
+#define DEV_OP_START()                  (0)
+#endif /* defined(MR_USING_DEV_STATS) || defined(MR_USING_TRACE) */
+
+static int dev_read_take(struct mr_dev *dev, int position, int sync, uint32_t start)
+{
+    /* Only used by the statistics */
+    (void)start;
+
+#ifdef MR_USING_RDWR_CTL
+    mr_interrupt_disable();
+    int ret = dev_lock_take(dev, (MR_LOCK_RD | MR_LOCK_CTL | MR_LOCK_SLEEP), MR_LOCK_RD);
+    mr_interrupt_enable();
+    if (ret < 0) {
+#ifdef MR_USING_DEV_STATS
+        dev_stats_update(&dev->stats.rd, ret, start);
+#endif /* MR_USING_DEV_STATS */
+        return ret;
+    }
 #endif /* MR_USING_RDWR_CTL */
 
     /* Update information */
     dev->sync = sync;
     dev->position = position;
 
-    /* Read buffer from the device */
-    ssize_t ret = dev->ops->read(dev, buf, count);
+#ifdef MR_USING_DEV_POLL
+    /* Not readable until the read is proved to be not draining the device, the read interrupt sets it again */
+    dev_poll_clear(dev, MR_POLL_RD);
+#endif /* MR_USING_DEV_POLL */
+    return MR_EOK;
+}
+
+MR_INLINE void dev_read_account(struct mr_dev *dev, ssize_t ret, size_t count, uint32_t start)
+{
+    /* Not all of them are used in every configuration */
+    (void)dev;
+    (void)ret;
+    (void)count;
+    (void)start;
+
+#ifdef MR_USING_DEV_STATS
+    dev_stats_update(&dev->stats.rd, ret, start);
+#endif /* MR_USING_DEV_STATS */
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_DEV_READ, start, dev, (int)count, (int)ret);
+#endif /* MR_USING_TRACE */
+}
+
+static void dev_read_release(struct mr_dev *dev, ssize_t ret, size_t count, uint32_t start)
+{
+#ifdef MR_USING_DEV_POLL
+    if ((ret > 0) && ((size_t)ret == count)) {
+        dev_poll_set(dev, MR_POLL_RD);
+    }
+#endif /* MR_USING_DEV_POLL */
 
 #ifdef MR_USING_RDWR_CTL
+    mr_interrupt_disable();
     dev_lock_release(dev, MR_LOCK_RD);
+    mr_interrupt_enable();
 #endif /* MR_USING_RDWR_CTL */
-    return ret;
+    dev_read_account(dev, ret, count, start);
 }
 
-MR_INLINE ssize_t dev_write(struct mr_dev *dev,
-                            int position,
-                            int sync,
-                            const void *buf,
-                            size_t count)
+static int dev_write_take(struct mr_dev *dev, int position, int sync, uint32_t start, int *nonblock)
 {
+    /* Only used by the statistics */
+    (void)start;
+
+    *nonblock = MR_FALSE;
+
 #ifdef MR_USING_RDWR_CTL
-    do {
-        mr_interrupt_disable();
-        int ret = dev_lock_take(dev,
-                                (MR_LOCK_WR |
-                                 MR_LOCK_SLEEP |
-                                 (sync == MR_SYNC ? MR_LOCK_NONBLOCK : 0)),
-                                MR_LOCK_WR);
-        if (ret < 0) {
-            mr_interrupt_enable();
-            return ret;
-        }
+    mr_interrupt_disable();
+    int ret = dev_lock_take(dev,
+                            (MR_LOCK_WR | MR_LOCK_CTL | MR_LOCK_SLEEP | (sync == MR_SYNC ? MR_LOCK_NONBLOCK : 0)),
+                            MR_LOCK_WR);
+    if (ret < 0) {
         mr_interrupt_enable();
-    } while (0);
+#ifdef MR_USING_DEV_STATS
+        dev_stats_update(&dev->stats.wr, ret, start);
+#endif /* MR_USING_DEV_STATS */
+        return ret;
+    }
+
+    /* Hold until the write interrupt, taken before the write in case the interrupt comes before it returns */
+    if ((sync == MR_ASYNC) && (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_DISABLE)) {
+        dev_lock_take(dev, 0, MR_LOCK_NONBLOCK);
+        *nonblock = MR_TRUE;
+    }
+    mr_interrupt_enable();
 #endif /* MR_USING_RDWR_CTL */
 
     /* Update information */
     dev->sync = sync;
     dev->position = position;
 
-    /* Write buffer to the device */
-    ssize_t ret = dev->ops->write(dev, buf, count);
+#ifdef MR_USING_DEV_POLL
+    /* Not writable while an asynchronous write is in flight, the write interrupt sets it again */
+    if (sync == MR_ASYNC) {
+        dev_poll_clear(dev, MR_POLL_WR);
+    }
+#endif /* MR_USING_DEV_POLL */
+    return MR_EOK;
+}
+
+MR_INLINE void dev_write_account(struct mr_dev *dev, ssize_t ret, size_t count, uint32_t start)
+{
+    /* Not all of them are used in every configuration */
+    (void)dev;
+    (void)ret;
+    (void)count;
+    (void)start;
+
+#ifdef MR_USING_DEV_STATS
+    dev_stats_update(&dev->stats.wr, ret, start);
+#endif /* MR_USING_DEV_STATS */
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_DEV_WRITE, start, dev, (int)count, (int)ret);
+#endif /* MR_USING_TRACE */
+}
+
+static void dev_write_release(struct mr_dev *dev, int sync, int nonblock, ssize_t ret, size_t count, uint32_t start)
+{
+    /* Not all of them are used in every configuration */
+    (void)sync;
+    (void)nonblock;
+
+#ifdef MR_USING_DEV_POLL
+    if ((sync == MR_ASYNC) && (ret <= 0)) {
+        dev_poll_set(dev, MR_POLL_WR);
+    }
+#endif /* MR_USING_DEV_POLL */
 
 #ifdef MR_USING_RDWR_CTL
+    mr_interrupt_disable();
     dev_lock_release(dev, MR_LOCK_WR);
-    if ((sync == MR_ASYNC) && (ret > 0)) {
-        mr_interrupt_disable();
-        dev_lock_take(dev, 0, MR_LOCK_NONBLOCK);
-        mr_interrupt_enable();
+    if ((nonblock == MR_TRUE) && (ret <= 0) && (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_ENABLE)) {
+        dev_lock_release(dev, MR_LOCK_NONBLOCK);
     }
+    mr_interrupt_enable();
 #endif /* MR_USING_RDWR_CTL */
+    dev_write_account(dev, ret, count, start);
+}
+
+MR_INLINE size_t dev_iov_count(const struct mr_dev_iovec *iov, size_t iovcnt)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < iovcnt; i++) {
+        count += iov[i].count;
+    }
+    return count;
+}
+
+MR_INLINE ssize_t dev_read(struct mr_dev *dev, int position, int sync, void *buf, size_t count)
+{
+    uint32_t start = DEV_OP_START();
+
+    ssize_t ret = dev_read_take(dev, position, sync, start);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Read buffer from the device */
+    ret = dev->ops->read(dev, buf, count);
+
+    dev_read_release(dev, ret, count, start);
+    return ret;
+}
+
+MR_INLINE ssize_t dev_write(struct mr_dev *dev,
+                            int position,
+                            int sync,
+                            const void *buf,
+                            size_t count)
+{
+    uint32_t start = DEV_OP_START();
+    int nonblock;
+
+    ssize_t ret = dev_write_take(dev, position, sync, start, &nonblock);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Write buffer to the device */
+    ret = dev->ops->write(dev, buf, count);
+
+    dev_write_release(dev, sync, nonblock, ret, count, start);
+    return ret;
+}
+
+MR_INLINE ssize_t dev_readv(struct mr_dev *dev,
+                            int position,
+                            int sync,
+                            const struct mr_dev_iovec *iov,
+                            size_t iovcnt)
+{
+    uint32_t start = DEV_OP_START();
+
+    /*
+     * Without the readv operation the buffers are read one by one at the same position, that is right for a channel
+     * but not for a register address, so a positioned device must support it to gather more than one buffer
+     */
+    if ((dev->ops->readv == MR_NULL) && (position >= 0) && (iovcnt > 1)) {
+        return MR_ENOTSUP;
+    }
+
+    ssize_t ret = dev_read_take(dev, position, sync, start);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Read buffers from the device, one by one if the device does not support it */
+    if (dev->ops->readv != MR_NULL) {
+        ret = dev->ops->readv(dev, iov, iovcnt);
+    } else {
+        for (size_t i = 0; i < iovcnt; i++) {
+            ssize_t size = dev->ops->read(dev, iov[i].buf, iov[i].count);
+            if (size < 0) {
+                ret = (ret == 0) ? size : ret;
+                break;
+            }
+            ret += size;
+            if ((size_t)size < iov[i].count) {
+                break;
+            }
+        }
+    }
+
+    dev_read_release(dev, ret, dev_iov_count(iov, iovcnt), start);
+    return ret;
+}
+
+MR_INLINE ssize_t dev_writev(struct mr_dev *dev,
+                             int position,
+                             int sync,
+                             const struct mr_dev_iovec *iov,
+                             size_t iovcnt)
+{
+    uint32_t start = DEV_OP_START();
+    int nonblock;
+
+    /* As with the readv, a positioned device must support the writev to scatter more than one buffer */
+    if ((dev->ops->writev == MR_NULL) && (position >= 0) && (iovcnt > 1)) {
+        return MR_ENOTSUP;
+    }
+
+    ssize_t ret = dev_write_take(dev, position, sync, start, &nonblock);
+    if (ret < 0) {
+        return ret;
+    }
+
+    /* Write buffers to the device, one by one if the device does not support it */
+    if (dev->ops->writev != MR_NULL) {
+        ret = dev->ops->writev(dev, iov, iovcnt);
+    } else {
+        for (size_t i = 0; i < iovcnt; i++) {
+            ssize_t size = dev->ops->write(dev, iov[i].buf, iov[i].count);
+            if (size < 0) {
+                ret = (ret == 0) ? size : ret;
+                break;
+            }
+            ret += size;
+            if ((size_t)size < iov[i].count) {
+                break;
+            }
+        }
+    }
+
+    dev_write_release(dev, sync, nonblock, ret, dev_iov_count(iov, iovcnt), start);
     return ret;
 }
 
 MR_INLINE int dev_ioctl(struct mr_dev *dev, int position, int sync, int cmd, void *args)
 {
+#if defined(MR_USING_DEV_STATS) || defined(MR_USING_TRACE)
+    uint32_t start = mr_cycle_get();
+#endif /* defined(MR_USING_DEV_STATS) || defined(MR_USING_TRACE) */
+
     if (dev->ops->ioctl == MR_NULL) {
+#ifdef MR_USING_DEV_STATS
+        dev_stats_update(&dev->stats.ioctl, MR_ENOTSUP, start);
+#endif /* MR_USING_DEV_STATS */
         return MR_ENOTSUP;
     }
 
 #ifdef MR_USING_RDWR_CTL
     do {
-        /* Lock only when user -> device command */
-        if (cmd) {
-            mr_interrupt_disable();
-            int ret = dev_lock_take(dev,
-                                    (MR_LOCK_RDWR | MR_LOCK_SLEEP | MR_LOCK_NONBLOCK),
-                                    MR_LOCK_RDWR);
-            if (ret < 0) {
-                mr_interrupt_enable();
-                return ret;
-            }
+        /*
+         * Lock exclusively only when user -> device command, device -> user command is shared. The command waits
+         * for the asynchronous writes, unless it is flagged as asynchronous (the device guards it itself)
+         */
+        mr_interrupt_disable();
+        int ret = (cmd > 0) ? dev_lock_take(dev,
+                                            (MR_LOCK_RDWR |
+                                             MR_LOCK_CTL |
+                                             MR_LOCK_SLEEP |
+                                             ((cmd & MR_IOC_ASYNC) ? 0 : MR_LOCK_NONBLOCK)),
+                                            (MR_LOCK_RDWR | MR_LOCK_CTL)) :
+                  dev_lock_take(dev, (MR_LOCK_CTL | MR_LOCK_SLEEP), 0);
+        if (ret < 0) {
             mr_interrupt_enable();
+#ifdef MR_USING_DEV_STATS
+            dev_stats_update(&dev->stats.ioctl, ret, start);
+#endif /* MR_USING_DEV_STATS */
+            return ret;
         }
+        mr_interrupt_enable();
     } while (0);
 #endif /* MR_USING_RDWR_CTL */
 
@@ -328,42 +829,72 @@ MR_INLINE int dev_ioctl(struct mr_dev *dev, int position, int sync, int cmd, voi
     dev->position = position;
 
     /* I/O control to the device */
+#ifdef MR_USING_HEAP_STATS
+    /* Only the set commands may allocate buffers */
+    const char *tag = (cmd > 0) ? mr_heap_set_tag(dev->name) : MR_NULL;
+    int ret = dev->ops->ioctl(dev, cmd, args);
+    if (cmd > 0) {
+        mr_heap_set_tag(tag);
+    }
+#else
     int ret = dev->ops->ioctl(dev, cmd, args);
+#endif /* MR_USING_HEAP_STATS */
 
 #ifdef MR_USING_RDWR_CTL
-    dev_lock_release(dev, MR_LOCK_RDWR);
+    mr_interrupt_disable();
+    dev_lock_release(dev, (cmd > 0) ? (MR_LOCK_RDWR | MR_LOCK_CTL) : 0);
+    mr_interrupt_enable();
 #endif /* MR_USING_RDWR_CTL */
+#ifdef MR_USING_DEV_STATS
+    dev_stats_update(&dev->stats.ioctl, ret, start);
+#endif /* MR_USING_DEV_STATS */
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_DEV_IOCTL, start, dev, (int)cmd, (int)ret);
+#endif /* MR_USING_TRACE */
     return ret;
 }
 
 MR_INLINE int desc_allocate(const char *path)
 {
-    int desc = -1;
+    int index;
 
     struct mr_dev *dev = dev_find(path);
     if (dev == MR_NULL) {
         return MR_ENOTFOUND;
     }
 
-    /* Find a free descriptor */
-    for (size_t i = 0; i < MR_CFG_DESC_NUM; i++) {
-        if (DESC_OF(i).dev == MR_NULL) {
-            desc = (int)i;
-            break;
+    /* Take a free descriptor, otherwise use a new one */
+    if (desc_free_head >= 0) {
+        index = desc_free_head;
+        desc_free_head = desc_get(index)->next;
+    } else {
+        if (desc_used_num == DESC_MAX_NUM) {
+            return MR_ENOMEM;
         }
-    }
-    if (desc < 0) {
-        return MR_ENOMEM;
+#ifdef MR_USING_DESC_GROW
+        /* Grow the descriptor map */
+        if ((desc_used_num % MR_CFG_DESC_NUM) == 0 && (desc_used_num != 0)) {
+            size_t grow = (desc_used_num / MR_CFG_DESC_NUM) - 1;
+
+            desc_grow_map[grow] = (struct mr_dev_desc *)mr_calloc(MR_CFG_DESC_NUM, sizeof(struct mr_dev_desc));
+            if (desc_grow_map[grow] == MR_NULL) {
+                return MR_ENOMEM;
+            }
+        }
+#endif /* MR_USING_DESC_GROW */
+        index = (int)desc_used_num++;
+        desc_get(index)->id = index;
     }
 
-    DESC_OF(desc).dev = dev;
-    DESC_OF(desc).flags = MR_O_CLOSED;
-    DESC_OF(desc).position = -1;
-    DESC_OF(desc).rd_call.fn = MR_NULL;
-    DESC_OF(desc).wr_call.fn = MR_NULL;
-    mr_list_init(&DESC_OF(desc).rd_call.list);
-    mr_list_init(&DESC_OF(desc).wr_call.list);
-    return desc;
+    struct mr_dev_desc *desc = desc_get(index);
+    desc->dev = dev;
+    desc->flags = MR_O_CLOSED;
+    desc->position = -1;
+    desc->rd_call.fn = MR_NULL;
+    desc->wr_call.fn = MR_NULL;
+    mr_list_init(&desc->rd_call.list);
+    mr_list_init(&desc->wr_call.list);
+    return desc->id;
 }
 
 MR_INLINE void desc_free(int desc)
@@ -376,7 +907,401 @@ MR_INLINE void desc_free(int desc)
         DESC_OF(desc).wr_call.fn = MR_NULL;
         mr_list_remove(&DESC_OF(desc).rd_call.list);
         mr_list_remove(&DESC_OF(desc).wr_call.list);
+
+        /* Step the generation so that the closed descriptor stays invalid, then put it to the free list */
+        DESC_OF(desc).id = (int)(((((size_t)desc >> DESC_INDEX_BITS) + 1) & DESC_GEN_MASK) << DESC_INDEX_BITS) |
+                           (int)DESC_INDEX(desc);
+        DESC_OF(desc).next = desc_free_head;
+        desc_free_head = (int)DESC_INDEX(desc);
+    }
+}
+
+static void dev_call(struct mr_dev *dev, int event, void *args)
+{
+#ifdef MR_USING_DEV_STATS
+    uint32_t start = mr_cycle_get();
+#endif /* MR_USING_DEV_STATS */
+
+    /* Call the all set callbacks */
+    if ((event & MR_ISR_MASK) == MR_ISR_RD) {
+        for (struct mr_list *list = dev->rd_call_list.next; list != &dev->rd_call_list; list = list->next) {
+            struct mr_dev_desc *desc = (struct mr_dev_desc *)MR_CONTAINER_OF(list, struct mr_dev_desc, rd_call.list);
+            if (desc->rd_call.fn != MR_NULL) {
+                desc->rd_call.fn(desc->id, args);
+            }
+        }
+    } else {
+        for (struct mr_list *list = dev->wr_call_list.next; list != &dev->wr_call_list; list = list->next) {
+            struct mr_dev_desc *desc = (struct mr_dev_desc *)MR_CONTAINER_OF(list, struct mr_dev_desc, wr_call.list);
+            if (desc->wr_call.fn != MR_NULL) {
+                desc->wr_call.fn(desc->id, args);
+            }
+        }
+    }
+#ifdef MR_USING_DEV_STATS
+    dev_stats_update(&dev->stats.call, 0, start);
+#endif /* MR_USING_DEV_STATS */
+}
+
+#ifdef MR_USING_DEV_DEFER
+#if defined(__GNUC__)
+#define DEV_DEFER_LOAD(value)           __atomic_load_n(&(value), __ATOMIC_ACQUIRE)
+#define DEV_DEFER_STORE(value, new)     __atomic_store_n(&(value), (new), __ATOMIC_RELEASE)
+#ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
+#define DEV_DEFER_CLAIM(value, old)     __atomic_compare_exchange_n(&(value), &(old), (old) + 1, MR_FALSE, \
+                                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define DEV_DEFER_INC(value)            __atomic_fetch_add(&(value), 1, __ATOMIC_RELAXED)
+#else
+/* Without compare-and-swap the interrupts calling mr_dev_isr() must not preempt each other */
+#define DEV_DEFER_CLAIM(value, old)     ((value) = (old) + 1, MR_TRUE)
+#define DEV_DEFER_INC(value)            ((value)++)
+#endif /* __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4 */
+#else
+#error "Device deferred dispatch requires the GCC atomic builtins"
+#endif /* defined(__GNUC__) */
+#define DEV_DEFER_MASK                  (MR_CFG_DEV_DEFER_NUM - 1)
+
+static int dev_defer_push(struct mr_dev *dev, int event, void *args)
+{
+    uint32_t tail = DEV_DEFER_LOAD(dev_defer_tail);
+
+    /* Claim an event, it is free when its lap is the one of the tail */
+    while (1) {
+        struct dev_defer_event *defer = &dev_defer_queue[tail & DEV_DEFER_MASK];
+        int32_t diff = (int32_t)(DEV_DEFER_LOAD(defer->lap) - ((tail & ~DEV_DEFER_MASK) << 1));
+
+        if (diff == 0) {
+            if (DEV_DEFER_CLAIM(dev_defer_tail, tail) == MR_TRUE) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* The driver has handled the event already, only its callbacks are lost */
+            DEV_DEFER_INC(dev_defer_stats.lost);
+            return MR_EOK;
+        } else {
+            tail = DEV_DEFER_LOAD(dev_defer_tail);
+        }
+    }
+
+    /* Copy the argument (an int, or a size_t with MR_ISR_ARG_SIZE), it may not live until the dispatch */
+    struct dev_defer_event *defer = &dev_defer_queue[tail & DEV_DEFER_MASK];
+    defer->dev = dev;
+    defer->event = event;
+    defer->has_value = (args != MR_NULL) ? MR_TRUE : MR_FALSE;
+    if (args != MR_NULL) {
+        defer->value = (MR_BIT_IS_SET(event, MR_ISR_ARG_SIZE) == MR_ENABLE) ? *(size_t *)args : (size_t)*(int *)args;
+    }
+    DEV_DEFER_STORE(defer->lap, ((tail & ~DEV_DEFER_MASK) << 1) + 1);
+
+    /* Update the statistics, the peak is only a hint when interrupts nest */
+    DEV_DEFER_INC(dev_defer_stats.queued);
+    uint32_t pending = tail + 1 - DEV_DEFER_LOAD(dev_defer_head);
+    if (pending > dev_defer_stats.peak) {
+        dev_defer_stats.peak = pending;
+    }
+    return MR_EOK;
+}
+#endif /* MR_USING_DEV_DEFER */
+
+#ifdef MR_USING_DEV_AIO
+#define DEV_AIO_RD_RUN                  (0x01)                      /* A thread is running the read requests */
+#define DEV_AIO_RD_AGAIN                (0x02)                      /* The read interrupt came meanwhile */
+#define DEV_AIO_WR_RUN                  (0x04)                      /* A thread is running the write requests */
+#define DEV_AIO_WR_AGAIN                (0x08)                      /* The write interrupt came meanwhile */
+
+/*
+ * The requests of a device hold its read or write lock while their list is not empty, so the synchronous I/O is
+ * refused until they are completed, and a request started from the interrupt never runs under another operation.
+ * A thread submitting requests runs them with the interrupts enabled, meanwhile the interrupt only leaves a note.
+ */
+MR_INLINE int dev_aio_lock_take(struct mr_dev *dev, uint32_t lock)
+{
+#ifdef MR_USING_RDWR_CTL
+    return dev_lock_take(dev, (lock | MR_LOCK_CTL | MR_LOCK_SLEEP), lock);
+#else
+    (void)dev;
+    (void)lock;
+    return MR_EOK;
+#endif /* MR_USING_RDWR_CTL */
+}
+
+MR_INLINE void dev_aio_done(struct mr_dev *dev, struct mr_list *aio_list, uint32_t lock, struct mr_dev_aio *aio)
+{
+    mr_list_remove(&aio->list);
+    mr_list_insert_before(&dev_aio_done_list, &aio->list);
+
+#ifdef MR_USING_RDWR_CTL
+    /* Give the device back to the synchronous I/O after the last request */
+    if (mr_list_is_empty(aio_list) == MR_TRUE) {
+        dev_lock_release(dev, lock);
+    }
+#else
+    (void)dev;
+    (void)aio_list;
+    (void)lock;
+#endif /* MR_USING_RDWR_CTL */
+}
+
+static ssize_t dev_aio_read_one(struct mr_dev *dev, struct mr_dev_aio *aio)
+{
+    int sync = dev->sync, position = dev->position;
+    uint32_t start = DEV_OP_START();
+
+    dev->sync = MR_ASYNC;
+    dev->position = DESC_OF(aio->desc).position;
+    ssize_t ret = dev->ops->read(dev, aio->buf, aio->count);
+    dev_read_account(dev, ret, aio->count, start);
+
+    /* Restore the information of the shared control that may be interrupted */
+    dev->sync = sync;
+    dev->position = position;
+    return ret;
+}
+
+static ssize_t dev_aio_write_one(struct mr_dev *dev, struct mr_dev_aio *aio)
+{
+    int sync = dev->sync, position = dev->position;
+    uint32_t start = DEV_OP_START();
+
+    dev->sync = MR_ASYNC;
+    dev->position = DESC_OF(aio->desc).position;
+    ssize_t ret = dev->ops->write(dev, aio->buf, aio->count);
+    dev_write_account(dev, ret, aio->count, start);
+
+    /* Restore the information of the shared control that may be interrupted */
+    dev->sync = sync;
+    dev->position = position;
+    return ret;
+}
+
+static void dev_aio_read_next(struct mr_dev *dev)
+{
+    /* Complete the requests in order until the device has no data */
+    while (mr_list_is_empty(&dev->rd_aio_list) == MR_FALSE) {
+        struct mr_dev_aio *aio = MR_CONTAINER_OF(dev->rd_aio_list.next, struct mr_dev_aio, list);
+
+        aio->ret = dev_aio_read_one(dev, aio);
+        if (aio->ret == 0) {
+#ifdef MR_USING_DEV_POLL
+            MR_BIT_CLR(dev->ready, MR_POLL_RD);
+#endif /* MR_USING_DEV_POLL */
+            break;
+        }
+        dev_aio_done(dev, &dev->rd_aio_list, MR_LOCK_RD, aio);
+    }
+}
+
+static void dev_aio_write_next(struct mr_dev *dev)
+{
+    /* Start the requests in order until one is in flight, the write interrupt completes it */
+    while (mr_list_is_empty(&dev->wr_aio_list) == MR_FALSE) {
+        struct mr_dev_aio *aio = MR_CONTAINER_OF(dev->wr_aio_list.next, struct mr_dev_aio, list);
+
+        if (aio->ret > 0) {
+            break;
+        }
+#ifdef MR_USING_RDWR_CTL
+        /* Wait for the asynchronous write before it, each request is held as non-blocking until it is written */
+        if (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_ENABLE) {
+            break;
+        }
+        dev_lock_take(dev, 0, MR_LOCK_NONBLOCK);
+#endif /* MR_USING_RDWR_CTL */
+        aio->ret = dev_aio_write_one(dev, aio);
+        if (aio->ret > 0) {
+            break;
+        }
+#ifdef MR_USING_RDWR_CTL
+        dev_lock_release(dev, MR_LOCK_NONBLOCK);
+#endif /* MR_USING_RDWR_CTL */
+        dev_aio_done(dev, &dev->wr_aio_list, MR_LOCK_WR, aio);
+    }
+}
+
+static void dev_aio_read_run(struct mr_dev *dev)
+{
+    /* Called with the interrupts disabled, the driver is called with them enabled */
+    MR_BIT_SET(dev->aio_run, DEV_AIO_RD_RUN);
+    while (mr_list_is_empty(&dev->rd_aio_list) == MR_FALSE) {
+        struct mr_dev_aio *aio = MR_CONTAINER_OF(dev->rd_aio_list.next, struct mr_dev_aio, list);
+
+        MR_BIT_CLR(dev->aio_run, DEV_AIO_RD_AGAIN);
+        mr_interrupt_enable();
+        ssize_t ret = dev_aio_read_one(dev, aio);
+        mr_interrupt_disable();
+
+        /* The request may be cancelled meanwhile */
+        if (dev->rd_aio_list.next != &aio->list) {
+            continue;
+        }
+        if (ret == 0) {
+            /* Try again if the read interrupt came during the read */
+            if (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_RD_AGAIN) == MR_ENABLE) {
+                continue;
+            }
+#ifdef MR_USING_DEV_POLL
+            MR_BIT_CLR(dev->ready, MR_POLL_RD);
+#endif /* MR_USING_DEV_POLL */
+            break;
+        }
+        aio->ret = ret;
+        dev_aio_done(dev, &dev->rd_aio_list, MR_LOCK_RD, aio);
+    }
+    MR_BIT_CLR(dev->aio_run, DEV_AIO_RD_RUN | DEV_AIO_RD_AGAIN);
+}
+
+static void dev_aio_write_run(struct mr_dev *dev)
+{
+    /* Called with the interrupts disabled, the driver is called with them enabled */
+    MR_BIT_SET(dev->aio_run, DEV_AIO_WR_RUN);
+    while (mr_list_is_empty(&dev->wr_aio_list) == MR_FALSE) {
+        struct mr_dev_aio *aio = MR_CONTAINER_OF(dev->wr_aio_list.next, struct mr_dev_aio, list);
+
+        if (aio->ret > 0) {
+            break;
+        }
+#ifdef MR_USING_RDWR_CTL
+        if (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_ENABLE) {
+            break;
+        }
+        dev_lock_take(dev, 0, MR_LOCK_NONBLOCK);
+#endif /* MR_USING_RDWR_CTL */
+        MR_BIT_CLR(dev->aio_run, DEV_AIO_WR_AGAIN);
+        mr_interrupt_enable();
+        ssize_t ret = dev_aio_write_one(dev, aio);
+        mr_interrupt_disable();
+
+        /* The request may be cancelled meanwhile, a write that is not in flight gives the non-blocking lock back */
+        if (dev->wr_aio_list.next != &aio->list) {
+#ifdef MR_USING_RDWR_CTL
+            if ((ret <= 0) && (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_ENABLE)) {
+                dev_lock_release(dev, MR_LOCK_NONBLOCK);
+            }
+#endif /* MR_USING_RDWR_CTL */
+            continue;
+        }
+        aio->ret = ret;
+        if (ret > 0) {
+            /* Completed already if the write interrupt came during the write, it released the non-blocking lock */
+            if (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_WR_AGAIN) == MR_DISABLE) {
+                break;
+            }
+            dev_aio_done(dev, &dev->wr_aio_list, MR_LOCK_WR, aio);
+            continue;
+        }
+#ifdef MR_USING_RDWR_CTL
+        if (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_ENABLE) {
+            dev_lock_release(dev, MR_LOCK_NONBLOCK);
+        }
+#endif /* MR_USING_RDWR_CTL */
+        dev_aio_done(dev, &dev->wr_aio_list, MR_LOCK_WR, aio);
+    }
+    MR_BIT_CLR(dev->aio_run, DEV_AIO_WR_RUN | DEV_AIO_WR_AGAIN);
+}
+
+static void dev_aio_cancel(struct mr_dev *dev, int desc)
+{
+    /* A request is cancelled with its descriptor, all of them when the device is closed */
+    for (struct mr_list *list = dev->rd_aio_list.next; list != &dev->rd_aio_list;) {
+        struct mr_dev_aio *aio = MR_CONTAINER_OF(list, struct mr_dev_aio, list);
+
+        list = list->next;
+        if ((aio->desc == desc) || (dev->ref_count == 0)) {
+            /* The read being run by a thread still owns its buffer, it completes when the read returns */
+            if ((&aio->list == dev->rd_aio_list.next) && (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_RD_RUN) == MR_ENABLE) &&
+                (dev->ref_count != 0)) {
+                continue;
+            }
+            aio->ret = MR_EIO;
+            dev_aio_done(dev, &dev->rd_aio_list, MR_LOCK_RD, aio);
+        }
+    }
+    for (struct mr_list *list = dev->wr_aio_list.next; list != &dev->wr_aio_list;) {
+        struct mr_dev_aio *aio = MR_CONTAINER_OF(list, struct mr_dev_aio, list);
+
+        list = list->next;
+        if ((aio->desc == desc) || (dev->ref_count == 0)) {
+            /* The write being run by a thread still owns its buffer, it completes when the write returns */
+            if ((&aio->list == dev->wr_aio_list.next) && (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_WR_RUN) == MR_ENABLE) &&
+                (dev->ref_count != 0)) {
+                continue;
+            }
+
+            /* The write in flight still owns its buffer, it completes from the write interrupt while open */
+            if (aio->ret > 0) {
+                if (dev->ref_count != 0) {
+                    continue;
+                }
+#ifdef MR_USING_RDWR_CTL
+                dev_lock_release(dev, MR_LOCK_NONBLOCK);
+#endif /* MR_USING_RDWR_CTL */
+            }
+            aio->ret = MR_EIO;
+            dev_aio_done(dev, &dev->wr_aio_list, MR_LOCK_WR, aio);
+        }
+    }
+}
+#endif /* MR_USING_DEV_AIO */
+
+static int dev_isr(struct mr_dev *dev, int event, void *args)
+{
+    if (dev->ops->isr != MR_NULL) {
+        ssize_t ret = dev->ops->isr(dev, event, args);
+        if (ret < 0) {
+            return (int)ret;
+        }
+    }
+
+    switch (event & MR_ISR_MASK) {
+        case MR_ISR_RD: {
+#ifdef MR_USING_DEV_POLL
+            MR_BIT_SET(dev->ready, MR_POLL_RD);
+#endif /* MR_USING_DEV_POLL */
+#ifdef MR_USING_DEV_AIO
+            if (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_RD_RUN) == MR_ENABLE) {
+                MR_BIT_SET(dev->aio_run, DEV_AIO_RD_AGAIN);
+            } else {
+                dev_aio_read_next(dev);
+            }
+#endif /* MR_USING_DEV_AIO */
+            break;
+        }
+        case MR_ISR_WR: {
+#ifdef MR_USING_RDWR_CTL
+            if (MR_BIT_IS_SET(dev->lock, MR_LOCK_NONBLOCK) == MR_ENABLE) {
+                dev_lock_release(dev, MR_LOCK_NONBLOCK);
+            }
+#endif /* MR_USING_RDWR_CTL */
+#ifdef MR_USING_DEV_POLL
+            MR_BIT_SET(dev->ready, MR_POLL_WR);
+#endif /* MR_USING_DEV_POLL */
+#ifdef MR_USING_DEV_AIO
+            /* Complete the request in flight and start the next one, or leave it to the thread running them */
+            if (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_WR_RUN) == MR_ENABLE) {
+                MR_BIT_SET(dev->aio_run, DEV_AIO_WR_AGAIN);
+            } else if (mr_list_is_empty(&dev->wr_aio_list) == MR_FALSE) {
+                struct mr_dev_aio *aio = MR_CONTAINER_OF(dev->wr_aio_list.next, struct mr_dev_aio, list);
+
+                if (aio->ret > 0) {
+                    dev_aio_done(dev, &dev->wr_aio_list, MR_LOCK_WR, aio);
+                }
+                dev_aio_write_next(dev);
+            }
+#endif /* MR_USING_DEV_AIO */
+            break;
+        }
+        default: {
+            return MR_ENOTSUP;
+        }
     }
+
+#ifdef MR_USING_DEV_DEFER
+    /* The callbacks are called by mr_dev_dispatch() */
+    return dev_defer_push(dev, event, args);
+#else
+    dev_call(dev, event, args);
+    return MR_EOK;
+#endif /* MR_USING_DEV_DEFER */
 }
 
 /**
@@ -419,14 +1344,30 @@ int mr_dev_register(struct mr_dev *dev,
     dev->parent = MR_NULL;
     mr_list_init(&dev->list);
     mr_list_init(&dev->clist);
+#ifdef MR_USING_DEV_HASH
+    dev->hash_next = MR_NULL;
+    dev->hash = 0;
+#endif /* MR_USING_DEV_HASH */
     dev->ref_count = 0;
 #ifdef MR_USING_RDWR_CTL
     dev->lock = 0;
+    dev->lock_dev = dev;
+    dev->lock_busy = 0;
 #endif /* MR_USING_RDWR_CTL */
     dev->sync = MR_SYNC;
     dev->position = -1;
+#ifdef MR_USING_DEV_POLL
+    dev->ready = MR_POLL_RD | MR_POLL_WR;
+#endif /* MR_USING_DEV_POLL */
     mr_list_init(&dev->rd_call_list);
     mr_list_init(&dev->wr_call_list);
+#ifdef MR_USING_DEV_AIO
+    mr_list_init(&dev->rd_aio_list);
+    mr_list_init(&dev->wr_aio_list);
+#endif /* MR_USING_DEV_AIO */
+#ifdef MR_USING_DEV_STATS
+    memset(&dev->stats, 0, sizeof(dev->stats));
+#endif /* MR_USING_DEV_STATS */
     dev->ops = ops;
     dev->drv = drv;
 
@@ -445,6 +1386,9 @@ int mr_dev_register(struct mr_dev *dev,
  *
  * @retval -6 device is closed or not supported.
  * @retval other error code.
+ *
+ * @note The argument of an event is an int, or a size_t if the event has MR_ISR_ARG_SIZE. With the deferred dispatch
+ *       it is copied with that type, and an event that does not fit in the full queue is counted as lost.
  */
 int mr_dev_isr(struct mr_dev *dev, int event, void *args)
 {
@@ -455,48 +1399,25 @@ int mr_dev_isr(struct mr_dev *dev, int event, void *args)
         return MR_ENOTSUP;
     }
 
-    if (dev->ops->isr != MR_NULL) {
-        ssize_t ret = dev->ops->isr(dev, event, args);
-        if (ret < 0) {
-            return (int)ret;
-        }
-    }
+#if defined(MR_USING_DEV_STATS) || defined(MR_USING_TRACE)
+    uint32_t start = mr_cycle_get();
+    int ret = dev_isr(dev, event, args);
 
-    /* Call the all set callbacks */
-    switch (event & MR_ISR_MASK) {
-        case MR_ISR_RD: {
-            for (struct mr_list *list = dev->rd_call_list.next;
-                 list != &dev->rd_call_list;
-                 list = list->next) {
-                struct mr_dev_desc *desc = (struct mr_dev_desc *)MR_CONTAINER_OF(list,
-                                                                                 struct mr_dev_desc,
-                                                                                 rd_call.list);
-                if (desc->rd_call.fn != MR_NULL) {
-                    desc->rd_call.fn((int)(desc - &desc_map[0]), args);
-                }
-            }
-            return MR_EOK;
-        }
-        case MR_ISR_WR: {
-#ifdef MR_USING_RDWR_CTL
-            dev_lock_release(dev, MR_LOCK_NONBLOCK);
-#endif /* MR_USING_RDWR_CTL */
-            for (struct mr_list *list = dev->wr_call_list.next;
-                 list != &dev->wr_call_list;
-                 list = list->next) {
-                struct mr_dev_desc *desc = (struct mr_dev_desc *)MR_CONTAINER_OF(list,
-                                                                                 struct mr_dev_desc,
-                                                                                 wr_call.list);
-                if (desc->wr_call.fn != MR_NULL) {
-                    desc->wr_call.fn((int)(desc - &desc_map[0]), args);
-                }
-            }
-            return MR_EOK;
-        }
-        default: {
-            return MR_ENOTSUP;
-        }
+#ifdef MR_USING_DEV_STATS
+    if ((event & MR_ISR_MASK) == MR_ISR_RD) {
+        dev->stats.rd_events++;
+    } else if ((event & MR_ISR_MASK) == MR_ISR_WR) {
+        dev->stats.wr_events++;
     }
+    dev_stats_update(&dev->stats.isr, ret, start);
+#endif /* MR_USING_DEV_STATS */
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_DEV_ISR, start, dev, event, ret);
+#endif /* MR_USING_TRACE */
+    return ret;
+#else
+    return dev_isr(dev, event, args);
+#endif /* defined(MR_USING_DEV_STATS) || defined(MR_USING_TRACE) */
 }
 
 /**
@@ -527,12 +1448,19 @@ int mr_dev_open(const char *path, int flags)
         return dev->flags;
     }
 
+#ifdef MR_USING_TRACE
+    uint32_t start = mr_cycle_get();
+#endif /* MR_USING_TRACE */
+
     /* Allocate descriptor and open device */
     int desc = desc_allocate(path);
     if (desc < 0) {
         return desc;
     }
     int ret = dev_open(DESC_OF(desc).dev, flags);
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_DEV_OPEN, start, DESC_OF(desc).dev, flags, (ret < 0) ? ret : desc);
+#endif /* MR_USING_TRACE */
     if (ret < 0) {
         desc_free(desc);
         return ret;
@@ -557,11 +1485,24 @@ int mr_dev_close(int desc)
 {
     MR_DESC_CHECK(desc);
 
+#ifdef MR_USING_TRACE
+    uint32_t start = mr_cycle_get();
+#endif /* MR_USING_TRACE */
+
     /* Close the device and free the descriptor */
     int ret = dev_close(DESC_OF(desc).dev);
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_DEV_CLOSE, start, DESC_OF(desc).dev, desc, ret);
+#endif /* MR_USING_TRACE */
     if (ret < 0) {
         return ret;
     }
+#ifdef MR_USING_DEV_AIO
+    /* Cancel the pending asynchronous requests of the descriptor */
+    mr_interrupt_disable();
+    dev_aio_cancel(DESC_OF(desc).dev, desc);
+    mr_interrupt_enable();
+#endif /* MR_USING_DEV_AIO */
     desc_free(desc);
     return MR_EOK;
 }
@@ -632,6 +1573,76 @@ ssize_t mr_dev_write(int desc, const void *buf, size_t count)
                      count);
 }
 
+/**
+ * @brief This function read a device into several buffers.
+ *
+ * @param desc The descriptor of the device.
+ * @param iov The buffers to be read.
+ * @param iovcnt The count of the buffers.
+ *
+ * @return The size of the actual read, otherwise an error code.
+ *
+ * @retval -4 is currently accessed by another.
+ * @retval -6 not supported read.
+ * @retval -7 descriptor is invalid.
+ * @retval other error code.
+ *
+ * @note The buffers are read in one access, the read stops at the first buffer that is not filled.
+ */
+ssize_t mr_dev_readv(int desc, const struct mr_dev_iovec *iov, size_t iovcnt)
+{
+    MR_ASSERT((iov != MR_NULL) || (iovcnt == 0));
+    MR_DESC_CHECK(desc);
+
+#ifdef MR_USING_RDWR_CTL
+    if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_RDONLY) == MR_DISABLE) {
+        return MR_ENOTSUP;
+    }
+#endif /* MR_USING_RDWR_CTL */
+
+    /* Read buffers from the device */
+    return dev_readv(DESC_OF(desc).dev,
+                     DESC_OF(desc).position,
+                     MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_NONBLOCK),
+                     iov,
+                     iovcnt);
+}
+
+/**
+ * @brief This function write a device from several buffers.
+ *
+ * @param desc The descriptor of the device.
+ * @param iov The buffers to be written.
+ * @param iovcnt The count of the buffers.
+ *
+ * @return The size of the actual write, otherwise an error code.
+ *
+ * @retval -4 is currently accessed by another.
+ * @retval -6 not supported write.
+ * @retval -7 descriptor is invalid.
+ * @retval other error code.
+ *
+ * @note The buffers are written in one access, the write stops at the first buffer that is not fully written.
+ */
+ssize_t mr_dev_writev(int desc, const struct mr_dev_iovec *iov, size_t iovcnt)
+{
+    MR_ASSERT((iov != MR_NULL) || (iovcnt == 0));
+    MR_DESC_CHECK(desc);
+
+#ifdef MR_USING_RDWR_CTL
+    if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_WRONLY) == MR_DISABLE) {
+        return MR_ENOTSUP;
+    }
+#endif /* MR_USING_RDWR_CTL */
+
+    /* Write buffers to the device */
+    return dev_writev(DESC_OF(desc).dev,
+                      DESC_OF(desc).position,
+                      MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_NONBLOCK),
+                      iov,
+                      iovcnt);
+}
+
 /**
  * @brief This function ioctl a device.
  *
@@ -700,6 +1711,20 @@ int mr_dev_ioctl(int desc, int cmd, void *args)
             mr_interrupt_enable();
             return sizeof(fn);
         }
+#ifdef MR_USING_DEV_STATS
+        case MR_IOC_CSTAT: {
+            mr_interrupt_disable();
+            memset(&DESC_OF(desc).dev->stats, 0, sizeof(DESC_OF(desc).dev->stats));
+            mr_interrupt_enable();
+            return MR_EOK;
+        }
+#endif /* MR_USING_DEV_STATS */
+#ifdef MR_USING_RDWR_CTL
+        case MR_IOC_CLOCK: {
+            DESC_OF(desc).dev->lock_busy = 0;
+            return MR_EOK;
+        }
+#endif /* MR_USING_RDWR_CTL */
         case MR_IOC_GPOS: {
             if (args != MR_NULL) {
                 int *position = (int *)args;
@@ -733,6 +1758,28 @@ int mr_dev_ioctl(int desc, int cmd, void *args)
             }
             return MR_EINVAL;
         }
+#ifdef MR_USING_DEV_STATS
+        case MR_IOC_GSTAT: {
+            if (args != MR_NULL) {
+                mr_interrupt_disable();
+                *(struct mr_dev_stats *)args = DESC_OF(desc).dev->stats;
+                mr_interrupt_enable();
+                return sizeof(struct mr_dev_stats);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_DEV_STATS */
+#ifdef MR_USING_RDWR_CTL
+        case MR_IOC_GLOCK: {
+            if (args != MR_NULL) {
+                uint32_t *busy = (uint32_t *)args;
+
+                *busy = DESC_OF(desc).dev->lock_busy;
+                return sizeof(*busy);
+            }
+            return MR_EINVAL;
+        }
+#endif /* MR_USING_RDWR_CTL */
         default: {
             /* I/O control to the device */
             return dev_ioctl(DESC_OF(desc).dev,
@@ -744,6 +1791,269 @@ int mr_dev_ioctl(int desc, int cmd, void *args)
     }
 }
 
+#ifdef MR_USING_DEV_AIO
+/**
+ * @brief This function submit an asynchronous read request.
+ *
+ * @param desc The descriptor of the device.
+ * @param aio The request, with the buffer, count and token set.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @retval -4 device is busy.
+ * @retval -6 not supported read.
+ * @retval -7 descriptor is invalid.
+ *
+ * @note The request completes when the device has data, with a non-blocking descriptor this happens from the read
+ *       interrupt of the device. Completed requests are collected by mr_dev_aio_reap(). While requests are queued,
+ *       the device is read locked and the synchronous reads are refused.
+ * @note The first request is read here with the interrupts enabled, the following ones from the read interrupt.
+ */
+int mr_dev_aio_read(int desc, struct mr_dev_aio *aio)
+{
+    MR_ASSERT(aio != MR_NULL);
+    MR_ASSERT((aio->buf != MR_NULL) || (aio->count == 0));
+    MR_DESC_CHECK(desc);
+
+#ifdef MR_USING_RDWR_CTL
+    if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_RDONLY) == MR_DISABLE) {
+        return MR_ENOTSUP;
+    }
+#endif /* MR_USING_RDWR_CTL */
+
+    struct mr_dev *dev = DESC_OF(desc).dev;
+    aio->desc = desc;
+    aio->ret = 0;
+
+    /* A blocking descriptor completes the request at once */
+    if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_NONBLOCK) == MR_DISABLE) {
+        aio->ret = dev_read(dev, DESC_OF(desc).position, MR_SYNC, aio->buf, aio->count);
+        mr_interrupt_disable();
+        mr_list_insert_before(&dev_aio_done_list, &aio->list);
+        mr_interrupt_enable();
+        return MR_EOK;
+    }
+
+    /* Queue the request, the first one takes the read lock and reads at once */
+    mr_interrupt_disable();
+    if (mr_list_is_empty(&dev->rd_aio_list) == MR_TRUE) {
+        int ret = dev_aio_lock_take(dev, MR_LOCK_RD);
+        if (ret < 0) {
+            mr_interrupt_enable();
+            return ret;
+        }
+        mr_list_insert_before(&dev->rd_aio_list, &aio->list);
+        dev_aio_read_run(dev);
+    } else {
+        mr_list_insert_before(&dev->rd_aio_list, &aio->list);
+    }
+    mr_interrupt_enable();
+    return MR_EOK;
+}
+
+/**
+ * @brief This function submit an asynchronous write request.
+ *
+ * @param desc The descriptor of the device.
+ * @param aio The request, with the buffer, count and token set.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @retval -4 device is busy.
+ * @retval -6 not supported write.
+ * @retval -7 descriptor is invalid.
+ *
+ * @note With a non-blocking descriptor the requests of a device are written one after another, each one completes
+ *       from the write interrupt of the device. Completed requests are collected by mr_dev_aio_reap(). While requests
+ *       are queued, the device is write locked and the synchronous writes are refused.
+ * @note The device must raise the write interrupt for each asynchronous write that returns a size, otherwise the
+ *       request stays in flight until the device is closed.
+ */
+int mr_dev_aio_write(int desc, struct mr_dev_aio *aio)
+{
+    MR_ASSERT(aio != MR_NULL);
+    MR_ASSERT((aio->buf != MR_NULL) || (aio->count == 0));
+    MR_DESC_CHECK(desc);
+
+#ifdef MR_USING_RDWR_CTL
+    if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_WRONLY) == MR_DISABLE) {
+        return MR_ENOTSUP;
+    }
+#endif /* MR_USING_RDWR_CTL */
+
+    struct mr_dev *dev = DESC_OF(desc).dev;
+    aio->desc = desc;
+    aio->ret = 0;
+
+    /* A blocking descriptor completes the request at once */
+    if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_NONBLOCK) == MR_DISABLE) {
+        aio->ret = dev_write(dev, DESC_OF(desc).position, MR_SYNC, aio->buf, aio->count);
+        mr_interrupt_disable();
+        mr_list_insert_before(&dev_aio_done_list, &aio->list);
+        mr_interrupt_enable();
+        return MR_EOK;
+    }
+
+    /* Queue the request, the first one takes the write lock, it is started at once if the device is idle */
+    mr_interrupt_disable();
+    if (mr_list_is_empty(&dev->wr_aio_list) == MR_TRUE) {
+        int ret = dev_aio_lock_take(dev, MR_LOCK_WR);
+        if (ret < 0) {
+            mr_interrupt_enable();
+            return ret;
+        }
+    }
+    mr_list_insert_before(&dev->wr_aio_list, &aio->list);
+    if (MR_BIT_IS_SET(dev->aio_run, DEV_AIO_WR_RUN) == MR_DISABLE) {
+        dev_aio_write_run(dev);
+    }
+    mr_interrupt_enable();
+    return MR_EOK;
+}
+
+/**
+ * @brief This function reap the completed asynchronous requests.
+ *
+ * @param aio The array to store the completed requests.
+ * @param num The number of the array.
+ *
+ * @return The number of the completed requests.
+ *
+ * @note The result of each request is in its ret field (the size of the actual read or write, otherwise an error
+ *       code). A request not yet written is cancelled with -2 when its descriptor is closed, the one in flight
+ *       completes from the write interrupt unless the device is closed.
+ */
+size_t mr_dev_aio_reap(struct mr_dev_aio **aio, size_t num)
+{
+    size_t i;
+
+    MR_ASSERT((aio != MR_NULL) || (num == 0));
+
+    mr_interrupt_disable();
+    for (i = 0; (i < num) && (mr_list_is_empty(&dev_aio_done_list) == MR_FALSE); i++) {
+        aio[i] = MR_CONTAINER_OF(dev_aio_done_list.next, struct mr_dev_aio, list);
+        mr_list_remove(&aio[i]->list);
+    }
+    mr_interrupt_enable();
+    return i;
+}
+#endif /* MR_USING_DEV_AIO */
+
+#ifdef MR_USING_DEV_POLL
+/**
+ * @brief This function poll the readiness of the descriptors.
+ *
+ * @param fds The descriptors, with the requested events (MR_POLL_RD and MR_POLL_WR) set.
+ * @param num The number of the descriptors.
+ *
+ * @return The number of the descriptors with returned events.
+ *
+ * @note The returned events of an invalid descriptor are MR_POLL_ERR. The readiness is a hint: it is set by the
+ *       interrupts of the device and cleared by a read that drains the device or an asynchronous write in flight,
+ *       so a ready descriptor may still read or write 0.
+ * @note The cost is one mask test per descriptor, not per ready descriptor: every entry of fds gets its returned
+ *       events written, so the descriptors are scanned rather than taken from a ready list.
+ */
+int mr_dev_poll(struct mr_dev_pollfd *fds, size_t num)
+{
+    int ready = 0;
+
+    MR_ASSERT((fds != MR_NULL) || (num == 0));
+
+    for (size_t i = 0; i < num; i++) {
+        int desc = fds[i].desc;
+
+        if (DESC_IS_VALID(desc) == MR_FALSE) {
+            fds[i].revents = MR_POLL_ERR;
+            ready++;
+            continue;
+        }
+
+        int events = fds[i].events & (MR_POLL_RD | MR_POLL_WR);
+#ifdef MR_USING_RDWR_CTL
+        /* Only the events allowed by the open flags are reported */
+        if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_RDONLY) == MR_DISABLE) {
+            MR_BIT_CLR(events, MR_POLL_RD);
+        }
+        if (MR_BIT_IS_SET(DESC_OF(desc).flags, MR_O_WRONLY) == MR_DISABLE) {
+            MR_BIT_CLR(events, MR_POLL_WR);
+        }
+#endif /* MR_USING_RDWR_CTL */
+        fds[i].revents = (int)(DESC_OF(desc).dev->ready & events);
+        if (fds[i].revents != 0) {
+            ready++;
+        }
+    }
+    return ready;
+}
+#endif /* MR_USING_DEV_POLL */
+
+#ifdef MR_USING_DEV_DEFER
+/**
+ * @brief This function dispatch the deferred device events.
+ *
+ * @return The number of the dispatched events.
+ *
+ * @note The read and write callbacks are called here instead of in the interrupts. It must be called from one thread
+ *       only, and dispatches at most MR_CFG_DEV_DEFER_NUM events per call so that an interrupt storm cannot hold it.
+ */
+size_t mr_dev_dispatch(void)
+{
+    uint32_t head = dev_defer_head;
+    size_t num = 0;
+
+    for (; num < MR_CFG_DEV_DEFER_NUM; num++) {
+        struct dev_defer_event *defer = &dev_defer_queue[head & DEV_DEFER_MASK];
+
+        /* Check whether the event is filled */
+        if (DEV_DEFER_LOAD(defer->lap) != (((head & ~DEV_DEFER_MASK) << 1) + 1)) {
+            break;
+        }
+        struct mr_dev *dev = defer->dev;
+        int event = defer->event;
+        size_t value = defer->value;
+        int int_value = (int)value;
+        int has_value = defer->has_value;
+
+        /* Free the event for the next lap before calling, so the interrupts can reuse it */
+        DEV_DEFER_STORE(defer->lap, ((head & ~DEV_DEFER_MASK) + MR_CFG_DEV_DEFER_NUM) << 1);
+        head++;
+        DEV_DEFER_STORE(dev_defer_head, head);
+
+        /* The device may be closed since the event */
+        if (dev->ref_count != 0) {
+            void *args = MR_NULL;
+
+            /* Give the argument back with the type of the event */
+            if (has_value == MR_TRUE) {
+                args = (MR_BIT_IS_SET(event, MR_ISR_ARG_SIZE) == MR_ENABLE) ? (void *)&value : (void *)&int_value;
+            }
+            dev_call(dev, event, args);
+        }
+    }
+    dev_defer_stats.dispatched += num;
+    return num;
+}
+
+/**
+ * @brief This function get the statistics of the deferred device events.
+ *
+ * @param stats The statistics.
+ *
+ * @return 0 on success, otherwise an error code.
+ */
+int mr_dev_get_dispatch_stats(struct mr_dev_dispatch_stats *stats)
+{
+    MR_ASSERT(stats != MR_NULL);
+
+    mr_interrupt_disable();
+    *stats = dev_defer_stats;
+    stats->pending = DEV_DEFER_LOAD(dev_defer_tail) - DEV_DEFER_LOAD(dev_defer_head);
+    mr_interrupt_enable();
+    return MR_EOK;
+}
+#endif /* MR_USING_DEV_DEFER */
+
 #if defined(MR_USING_MSH) && defined(MR_USING_MSH_DEV_CMD)
 #include "include/components/mr_msh.h"
 
@@ -783,9 +2093,9 @@ void msh_dlist_tree(struct mr_dev *parent, int level)
                       MR_CFG_DEV_NAME_LEN,
                       parent->name);
     }
-    for (size_t i = 0; i < MR_CFG_DESC_NUM; i++) {
-        if (desc_map[i].dev == parent) {
-            mr_msh_printf(" [%d]", i);
+    for (size_t i = 0; i < desc_used_num; i++) {
+        if (desc_get(i)->dev == parent) {
+            mr_msh_printf(" [%d]", desc_get(i)->id);
         }
     }
     mr_msh_printf("\r\n");
@@ -801,3 +2111,30 @@ struct mr_dev *msh_get_root(void)
 }
 
 #endif /* defined(MR_USING_MSH) && defined(MR_USING_MSH_DEV_CMD) */
+
+#if defined(MR_USING_MSH) && defined(MR_USING_TRACE)
+#include "include/components/mr_msh.h"
+
+static void dev_trace_print_tree(struct mr_dev *parent, char *path, size_t len, size_t bufsz)
+{
+    for (struct mr_list *child = parent->clist.next; child != &parent->clist; child = child->next) {
+        struct mr_dev *dev = MR_CONTAINER_OF(child, struct mr_dev, list);
+
+        /* Check whether the buffer is enough */
+        if ((bufsz - len) <= (strnlen(dev->name, MR_CFG_DEV_NAME_LEN) + 1)) {
+            continue;
+        }
+        int ret = snprintf(path + len, bufsz - len, "/%.*s", MR_CFG_DEV_NAME_LEN, dev->name);
+        mr_msh_printf("D %08x %s\r\n", (uint32_t)(uintptr_t)dev, path);
+        dev_trace_print_tree(dev, path, len + ret, bufsz);
+    }
+}
+
+void msh_trace_print_devs(void)
+{
+    char path[MR_CFG_DEV_NAME_LEN * 6] = {0};
+    int ret = snprintf(path, sizeof(path), "/%.*s", MR_CFG_DEV_NAME_LEN, root_dev.name);
+
+    dev_trace_print_tree(&root_dev, path, ret, sizeof(path));
+}
+#endif /* defined(MR_USING_MSH) && defined(MR_USING_TRACE) */
@@ -10,128 +10,979 @@
 
 #ifndef MR_CFG_HEAP_SIZE
 #define MR_CFG_HEAP_SIZE                (4 * 1024)                  /**< If not defined, use 4KB */
-#elif (MR_CFG_HEAP_SIZE < 16)
-#define MR_CFG_HEAP_SIZE                (16)                        /**< If less than 16, use 16B */
+#elif (MR_CFG_HEAP_SIZE < 64)
+#define MR_CFG_HEAP_SIZE                (64)                        /**< If less than 64, use 64B */
 #endif /* MR_CFG_HEAP_SIZE */
+#ifndef MR_CFG_HEAP_FLAGS
+#define MR_CFG_HEAP_FLAGS               (MR_HEAP_DMA)               /**< If not defined, the heap is DMA-capable */
+#endif /* MR_CFG_HEAP_FLAGS */
 static uint8_t heap_mem[MR_CFG_HEAP_SIZE] = {0};                    /**< Heap memory */
 
 #define MR_HEAP_BLOCK_FREE              (0)
 #define MR_HEAP_BLOCK_ALLOCATED         (1)
 #define MR_HEAP_BLOCK_MIN_SIZE          (sizeof(struct mr_heap_block) << 1)
-
-static struct mr_heap_block heap_start =                            /**< Heap start block */
-    {MR_NULL, 0, MR_HEAP_BLOCK_FREE};
+#define MR_HEAP_ALIGN_MIN               (4)                         /**< Alignment of all memory */
 
 /**
- * @brief This function initialize the heap.
+ * @brief Heap region structure.
+ *
+ * @note The region structure is placed at the start of the region memory, the blocks follow it.
  */
-static void mr_heap_init(void)
+struct heap_region
+{
+    struct heap_region *next;                                       /**< Next region (ascending priority) */
+    uint8_t *start;                                                 /**< Start of the blocks */
+    uint8_t *end;                                                   /**< End of the region */
+    int flags;                                                      /**< Region flags */
+    int priority;                                                   /**< Region priority */
+#ifndef MR_USING_HEAP_TLSF
+    struct mr_heap_block free;                                      /**< Free block list head */
+#else
+    uint32_t fl_bitmap;                                             /**< First-level bitmap */
+    uint32_t fl_num;                                                /**< First-level number */
+    uint8_t *sl_bitmap;                                             /**< Second-level bitmaps */
+    struct mr_heap_block **blocks;                                  /**< Free block lists */
+#endif /* MR_USING_HEAP_TLSF */
+};
+static struct heap_region *heap_region_list = MR_NULL;              /**< Heap region list */
+
+MR_INLINE void *heap_block_to_memory(struct mr_heap_block *block)
+{
+    return (void *)((uint8_t *)block + sizeof(struct mr_heap_block));
+}
+
+MR_INLINE struct mr_heap_block *heap_memory_to_block(void *memory)
 {
-    struct mr_heap_block *first_block = (struct mr_heap_block *)&heap_mem;
+    return (struct mr_heap_block *)((uint8_t *)memory - sizeof(struct mr_heap_block));
+}
+
+#ifndef MR_USING_HEAP_TLSF
+static int heap_region_init(struct heap_region *region)
+{
+    struct mr_heap_block *first_block = (struct mr_heap_block *)region->start;
+
+    if ((size_t)(region->end - region->start) < (MR_HEAP_BLOCK_MIN_SIZE + sizeof(struct mr_heap_block))) {
+        return MR_EINVAL;
+    }
 
     /* Initialize the first block */
     first_block->next = MR_NULL;
-    first_block->size = sizeof(heap_mem) - sizeof(struct mr_heap_block);
+    first_block->size = region->end - region->start - sizeof(struct mr_heap_block);
     first_block->allocated = MR_HEAP_BLOCK_FREE;
-    heap_start.next = first_block;
+    region->free.next = first_block;
+    region->free.size = 0;
+    region->free.allocated = MR_HEAP_BLOCK_FREE;
+    return MR_EOK;
 }
-MR_INIT_BOARD_EXPORT(mr_heap_init);
 
-static void heap_insert_block(struct mr_heap_block *block)
+static void heap_insert_block(struct heap_region *region, struct mr_heap_block *block)
 {
-    struct mr_heap_block *block_prev = &heap_start;
+    struct mr_heap_block *block_prev = &region->free;
 
     /* Search for the previous block */
     while (((block_prev->next != MR_NULL) && (block_prev->next < block))) {
         block_prev = block_prev->next;
     }
 
-    /* Insert the block */
-    if (block_prev->next != MR_NULL) {
-        /* Merge with the previous block */
-        if ((void *)(((uint8_t *)block_prev) + sizeof(struct mr_heap_block) + block_prev->size) ==
-            (void *)block) {
-            block_prev->size += block->size + sizeof(struct mr_heap_block);
-            block = block_prev;
-        }
-
-        /* Merge with the next block */
-        if ((void *)(((uint8_t *)block) + sizeof(struct mr_heap_block) + block->size) ==
-            (void *)block_prev->next) {
-            block->size += block_prev->next->size + sizeof(struct mr_heap_block);
-            block->next = block_prev->next->next;
-            if (block != block_prev) {
-                block_prev->next = block;
-                block = block_prev;
-            }
-        }
-    }
-
-    /* Insert the block */
-    if (block != block_prev) {
+    /* Merge with the previous block, the list head is adjacent to the first block but is not a block */
+    if ((block_prev != &region->free) &&
+        ((void *)(((uint8_t *)block_prev) + sizeof(struct mr_heap_block) + block_prev->size) == (void *)block)) {
+        block_prev->size += block->size + sizeof(struct mr_heap_block);
+        block = block_prev;
+    } else {
+        /* Insert the block */
         block->next = block_prev->next;
         block_prev->next = block;
     }
+
+    /* Merge with the next block */
+    if ((block->next != MR_NULL) &&
+        ((void *)(((uint8_t *)block) + sizeof(struct mr_heap_block) + block->size) == (void *)block->next)) {
+        block->size += block->next->size + sizeof(struct mr_heap_block);
+        block->next = block->next->next;
+    }
 }
 
-/**
- * @brief This function allocate memory.
- *
- * @param size The size of the memory.
- *
- * @return A pointer to the allocated memory.
- */
-MR_WEAK void *mr_malloc(size_t size)
+static struct mr_heap_block *heap_take_block(struct heap_region *region, size_t size)
 {
-    struct mr_heap_block *block_prev = &heap_start;
+    struct mr_heap_block *block_prev = &region->free;
     struct mr_heap_block *block = block_prev->next;
 
-    mr_interrupt_disable();
-
-    /* Check size and residual memory */
-    if ((size == 0) || (size > (UINT32_MAX >> 1) || (block == MR_NULL))) {
-        mr_interrupt_enable();
+    /* Search for and take blocks that match the criteria */
+    if (block == MR_NULL) {
         return MR_NULL;
     }
-
-    /* Align the size to the next multiple of 4 bytes */
-    size = MR_ALIGN_UP(size, 4);
-
-    /* Search for and take blocks that match the criteria */
     while (block->size < size) {
         if (block->next == MR_NULL) {
-            mr_interrupt_enable();
             return MR_NULL;
         }
         block_prev = block;
         block = block->next;
     }
     block_prev->next = block->next;
+    return block;
+}
 
-    /* Allocate memory */
-    void *memory = (void *)((uint8_t *)block + sizeof(struct mr_heap_block));
+static void heap_split_block(struct heap_region *region, struct mr_heap_block *block, size_t size)
+{
     size_t residual = block->size - size;
 
-    /* Set the block information */
-    block->size = size;
-    block->next = MR_NULL;
-    block->allocated = MR_HEAP_BLOCK_ALLOCATED;
-
     /* Check if we need to allocate a new block */
     if (residual > MR_HEAP_BLOCK_MIN_SIZE) {
-        struct mr_heap_block *new_block = (struct mr_heap_block *)(((uint8_t *)memory) + size);
+        struct mr_heap_block *new_block = (struct mr_heap_block *)((uint8_t *)heap_block_to_memory(block) +
+                                                                   size);
 
         /* Set the new block information */
         new_block->size = residual - sizeof(struct mr_heap_block);
         new_block->next = MR_NULL;
         new_block->allocated = MR_HEAP_BLOCK_FREE;
+        block->size = size;
+
+        /* Insert the new block */
+        heap_insert_block(region, new_block);
+    }
+}
+
+static void heap_release_block(struct heap_region *region, struct mr_heap_block *block)
+{
+    block->allocated = MR_HEAP_BLOCK_FREE;
+
+    /* Insert the free block */
+    heap_insert_block(region, block);
+}
+
+static struct mr_heap_block *heap_split_block_head(struct heap_region *region, struct mr_heap_block *block, size_t size)
+{
+    struct mr_heap_block *new_block = (struct mr_heap_block *)((uint8_t *)block + size);
+
+    /* Set the new block information */
+    new_block->size = block->size - size;
+    new_block->next = MR_NULL;
+    new_block->allocated = MR_HEAP_BLOCK_ALLOCATED;
+    block->size = size - sizeof(struct mr_heap_block);
+
+    /* Release the head block */
+    heap_release_block(region, block);
+    return new_block;
+}
+
+static void heap_merge_next_block(struct heap_region *region, struct mr_heap_block *block)
+{
+    struct mr_heap_block *next = (struct mr_heap_block *)((uint8_t *)heap_block_to_memory(block) + block->size);
+    struct mr_heap_block *block_prev = &region->free;
+
+    /* Check if the next block is free */
+    if (((uint8_t *)next >= region->end) || (next->allocated != MR_HEAP_BLOCK_FREE)) {
+        return;
+    }
+
+    /* Search for the previous free block */
+    while ((block_prev->next != MR_NULL) && (block_prev->next != next)) {
+        block_prev = block_prev->next;
+    }
+    if (block_prev->next == MR_NULL) {
+        return;
+    }
+
+    /* Take the next block */
+    block_prev->next = next->next;
+    block->size += next->size + sizeof(struct mr_heap_block);
+}
+
+#ifdef MR_USING_HEAP_STATS
+static size_t heap_region_get_free(struct heap_region *region, struct mr_heap_stats *stats)
+{
+    size_t max_free = 0;
+
+    for (struct mr_heap_block *block = region->free.next; block != MR_NULL; block = block->next) {
+        stats->free += block->size;
+        stats->free_blocks++;
+        if (block->size > max_free) {
+            max_free = block->size;
+        }
+    }
+    return max_free;
+}
+#endif /* MR_USING_HEAP_STATS */
+#else
+/**
+ * @brief TLSF (two-level segregated fit) configuration.
+ *
+ * @note The first-level index is the most significant bit of the size, the second-level index linearly
+ *       subdivides each first-level range. Small sizes share the first-level index 0.
+ */
+#define MR_HEAP_TLSF_ALIGN_SHIFT        (2)                         /**< Align to 4 bytes */
+#define MR_HEAP_TLSF_SL_SHIFT           (2)                         /**< Second-level lists (log2) */
+#define MR_HEAP_TLSF_SL_NUM             (1 << MR_HEAP_TLSF_SL_SHIFT)
+#define MR_HEAP_TLSF_FL_SHIFT           (MR_HEAP_TLSF_SL_SHIFT + MR_HEAP_TLSF_ALIGN_SHIFT)
+#define MR_HEAP_TLSF_SMALL_SIZE         (1 << MR_HEAP_TLSF_FL_SHIFT)
+
+MR_INLINE int heap_tlsf_fls(uint32_t word)
+{
+#if defined(__GNUC__)
+    return (word != 0) ? (31 - __builtin_clz(word)) : -1;
+#else
+    int bit = 31;
+
+    if (word == 0) {
+        return -1;
+    }
+    if ((word & 0xffff0000) == 0) {
+        word <<= 16;
+        bit -= 16;
+    }
+    if ((word & 0xff000000) == 0) {
+        word <<= 8;
+        bit -= 8;
+    }
+    if ((word & 0xf0000000) == 0) {
+        word <<= 4;
+        bit -= 4;
+    }
+    if ((word & 0xc0000000) == 0) {
+        word <<= 2;
+        bit -= 2;
+    }
+    if ((word & 0x80000000) == 0) {
+        bit -= 1;
+    }
+    return bit;
+#endif /* defined(__GNUC__) */
+}
+
+MR_INLINE int heap_tlsf_ffs(uint32_t word)
+{
+    return heap_tlsf_fls(word & (~word + 1));
+}
+
+MR_INLINE void heap_tlsf_mapping(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size < MR_HEAP_TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)size >> MR_HEAP_TLSF_ALIGN_SHIFT;
+    } else {
+        int bit = heap_tlsf_fls((uint32_t)size);
+
+        *sl = ((uint32_t)size >> (bit - MR_HEAP_TLSF_SL_SHIFT)) ^ MR_HEAP_TLSF_SL_NUM;
+        *fl = bit - (MR_HEAP_TLSF_FL_SHIFT - 1);
+    }
+}
+
+MR_INLINE struct mr_heap_block **heap_tlsf_prev_free(struct mr_heap_block *block)
+{
+    /* The previous free block is stored in the first word of the free memory */
+    return (struct mr_heap_block **)heap_block_to_memory(block);
+}
+
+MR_INLINE struct mr_heap_block *heap_tlsf_next_phys(struct mr_heap_block *block)
+{
+    return (struct mr_heap_block *)((uint8_t *)heap_block_to_memory(block) + block->size);
+}
+
+static void heap_tlsf_insert(struct heap_region *region, struct mr_heap_block *block)
+{
+    uint32_t fl, sl;
+
+    heap_tlsf_mapping(block->size, &fl, &sl);
+    struct mr_heap_block **head = &region->blocks[fl * MR_HEAP_TLSF_SL_NUM + sl];
+
+    /* Insert the block at the head of the list */
+    block->next = *head;
+    *heap_tlsf_prev_free(block) = MR_NULL;
+    if (*head != MR_NULL) {
+        *heap_tlsf_prev_free(*head) = block;
+    }
+    *head = block;
+    block->allocated = MR_HEAP_BLOCK_FREE;
+
+    /* Mark the lists as not empty */
+    MR_BIT_SET(region->fl_bitmap, (1U << fl));
+    MR_BIT_SET(region->sl_bitmap[fl], (1U << sl));
+}
+
+static void heap_tlsf_remove(struct heap_region *region, struct mr_heap_block *block)
+{
+    struct mr_heap_block *prev = *heap_tlsf_prev_free(block);
+    uint32_t fl, sl;
+
+    heap_tlsf_mapping(block->size, &fl, &sl);
+
+    /* Unlink the block */
+    if (block->next != MR_NULL) {
+        *heap_tlsf_prev_free(block->next) = prev;
+    }
+    if (prev != MR_NULL) {
+        prev->next = block->next;
+    } else {
+        region->blocks[fl * MR_HEAP_TLSF_SL_NUM + sl] = block->next;
+
+        /* Mark the lists as empty */
+        if (block->next == MR_NULL) {
+            MR_BIT_CLR(region->sl_bitmap[fl], (1U << sl));
+            if (region->sl_bitmap[fl] == 0) {
+                MR_BIT_CLR(region->fl_bitmap, (1U << fl));
+            }
+        }
+    }
+    block->next = MR_NULL;
+}
+
+static int heap_region_init(struct heap_region *region)
+{
+    uint8_t *start = region->start;
+    uint32_t fl, sl;
+
+    /* The control lists are placed at the start of the blocks, sized by the largest possible block */
+    heap_tlsf_mapping((size_t)(region->end - start), &fl, &sl);
+    size_t ctrl_size = MR_ALIGN_UP(((sizeof(struct mr_heap_block *) * MR_HEAP_TLSF_SL_NUM) + 1) * (fl + 1),
+                                   sizeof(void *));
+    if ((size_t)(region->end - start) < (ctrl_size + MR_HEAP_BLOCK_MIN_SIZE + sizeof(struct mr_heap_block))) {
+        return MR_EINVAL;
+    }
+    memset(start, 0, ctrl_size);
+    region->fl_bitmap = 0;
+    region->fl_num = fl + 1;
+    region->blocks = (struct mr_heap_block **)start;
+    region->sl_bitmap = start + (sizeof(struct mr_heap_block *) * MR_HEAP_TLSF_SL_NUM * region->fl_num);
+    start += ctrl_size;
+
+    /* Initialize the first block and the end block, the end block is never freed */
+    struct mr_heap_block *first_block = (struct mr_heap_block *)start;
+    struct mr_heap_block *end_block = (struct mr_heap_block *)(region->end - sizeof(struct mr_heap_block));
+
+    first_block->prev = MR_NULL;
+    first_block->size = (uint8_t *)end_block - start - sizeof(struct mr_heap_block);
+    end_block->next = MR_NULL;
+    end_block->prev = first_block;
+    end_block->size = 0;
+    end_block->allocated = MR_HEAP_BLOCK_ALLOCATED;
+    heap_tlsf_insert(region, first_block);
+    return MR_EOK;
+}
+
+static struct mr_heap_block *heap_take_block(struct heap_region *region, size_t size)
+{
+    uint32_t fl, sl;
+
+    /* Round up to the next list, every block in it is large enough */
+    if (size >= MR_HEAP_TLSF_SMALL_SIZE) {
+        size += (1U << (heap_tlsf_fls((uint32_t)size) - MR_HEAP_TLSF_SL_SHIFT)) - 1;
+    }
+    heap_tlsf_mapping(size, &fl, &sl);
+    if (fl >= region->fl_num) {
+        return MR_NULL;
+    }
+
+    /* Search for a non-empty list */
+    uint32_t sl_map = region->sl_bitmap[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        uint32_t fl_map = region->fl_bitmap & (~0U << (fl + 1));
+        if (fl_map == 0) {
+            return MR_NULL;
+        }
+        fl = heap_tlsf_ffs(fl_map);
+        sl_map = region->sl_bitmap[fl];
+    }
+    sl = heap_tlsf_ffs(sl_map);
+
+    /* Take the first block */
+    struct mr_heap_block *block = region->blocks[fl * MR_HEAP_TLSF_SL_NUM + sl];
+    heap_tlsf_remove(region, block);
+    return block;
+}
+
+static void heap_split_block(struct heap_region *region, struct mr_heap_block *block, size_t size)
+{
+    size_t residual = block->size - size;
+
+    /* Check if we need to allocate a new block */
+    if (residual > MR_HEAP_BLOCK_MIN_SIZE) {
+        struct mr_heap_block *new_block = (struct mr_heap_block *)((uint8_t *)heap_block_to_memory(block) +
+                                                                   size);
+
+        /* Set the new block information */
+        new_block->size = residual - sizeof(struct mr_heap_block);
+        new_block->prev = block;
+        heap_tlsf_next_phys(new_block)->prev = new_block;
+        block->size = size;
 
         /* Insert the new block */
-        heap_insert_block(new_block);
+        heap_tlsf_insert(region, new_block);
     }
+}
+
+static void heap_release_block(struct heap_region *region, struct mr_heap_block *block)
+{
+    struct mr_heap_block *next = heap_tlsf_next_phys(block);
+
+    /* Merge with the previous block */
+    if ((block->prev != MR_NULL) && (block->prev->allocated == MR_HEAP_BLOCK_FREE)) {
+        heap_tlsf_remove(region, block->prev);
+        block->prev->size += block->size + sizeof(struct mr_heap_block);
+        block = block->prev;
+    }
+
+    /* Merge with the next block */
+    if (next->allocated == MR_HEAP_BLOCK_FREE) {
+        heap_tlsf_remove(region, next);
+        block->size += next->size + sizeof(struct mr_heap_block);
+    }
+    heap_tlsf_next_phys(block)->prev = block;
+
+    /* Insert the free block */
+    heap_tlsf_insert(region, block);
+}
+
+static struct mr_heap_block *heap_split_block_head(struct heap_region *region, struct mr_heap_block *block, size_t size)
+{
+    struct mr_heap_block *new_block = (struct mr_heap_block *)((uint8_t *)block + size);
+
+    /* Set the new block information */
+    new_block->size = block->size - size;
+    new_block->next = MR_NULL;
+    new_block->prev = block;
+    new_block->allocated = MR_HEAP_BLOCK_ALLOCATED;
+    heap_tlsf_next_phys(new_block)->prev = new_block;
+    block->size = size - sizeof(struct mr_heap_block);
 
+    /* Insert the head block, the previous block is not free as the block was free */
+    heap_tlsf_insert(region, block);
+    return new_block;
+}
+
+static void heap_merge_next_block(struct heap_region *region, struct mr_heap_block *block)
+{
+    struct mr_heap_block *next = heap_tlsf_next_phys(block);
+
+    /* Take the next block if it is free, the end block is never free */
+    if (next->allocated == MR_HEAP_BLOCK_FREE) {
+        heap_tlsf_remove(region, next);
+        block->size += next->size + sizeof(struct mr_heap_block);
+        heap_tlsf_next_phys(block)->prev = block;
+    }
+}
+
+#ifdef MR_USING_HEAP_STATS
+static size_t heap_region_get_free(struct heap_region *region, struct mr_heap_stats *stats)
+{
+    size_t max_free = 0;
+
+    for (size_t i = 0; i < (region->fl_num * MR_HEAP_TLSF_SL_NUM); i++) {
+        for (struct mr_heap_block *block = region->blocks[i]; block != MR_NULL; block = block->next) {
+            stats->free += block->size;
+            stats->free_blocks++;
+            if (block->size > max_free) {
+                max_free = block->size;
+            }
+        }
+    }
+    return max_free;
+}
+#endif /* MR_USING_HEAP_STATS */
+#endif /* MR_USING_HEAP_TLSF */
+
+static struct heap_region *heap_region_find(struct mr_heap_block *block)
+{
+    struct heap_region *region = heap_region_list;
+
+    /* Search for the region containing the block */
+    while ((region != MR_NULL) && (((uint8_t *)block < region->start) || ((uint8_t *)block >= region->end))) {
+        region = region->next;
+    }
+    return region;
+}
+
+static struct mr_heap_block *heap_align_block(struct heap_region *region, struct mr_heap_block *block, size_t align)
+{
+    uintptr_t memory = (uintptr_t)heap_block_to_memory(block);
+    size_t gap = MR_ALIGN_UP(memory, align) - memory;
+
+    /* Split off the gap before the aligned memory, it must be large enough to be a free block */
+    if (gap != 0) {
+        if (gap < MR_HEAP_BLOCK_MIN_SIZE) {
+            gap += MR_ALIGN_UP(MR_HEAP_BLOCK_MIN_SIZE - gap, align);
+        }
+        block = heap_split_block_head(region, block, gap);
+    }
+    return block;
+}
+
+static struct mr_heap_block *heap_allocate_block(size_t size, size_t align, int flags)
+{
+    /* An aligned block is taken with room for the worst-case gap, which is given back after splitting */
+    size_t take_size = (align > MR_HEAP_ALIGN_MIN) ? (size + align + MR_HEAP_BLOCK_MIN_SIZE) : size;
+    int required = flags & MR_HEAP_DMA;
+
+    while (1) {
+        /* Search the regions in priority order */
+        for (struct heap_region *region = heap_region_list; region != MR_NULL; region = region->next) {
+            if ((region->flags & flags) != flags) {
+                continue;
+            }
+
+            struct mr_heap_block *block = heap_take_block(region, take_size);
+            if (block != MR_NULL) {
+                /* Set the block information and split the residual memory */
+                block->next = MR_NULL;
+                block->allocated = MR_HEAP_BLOCK_ALLOCATED;
+                if (align > MR_HEAP_ALIGN_MIN) {
+                    block = heap_align_block(region, block, align);
+                }
+                heap_split_block(region, block, size);
+                return block;
+            }
+        }
+
+        /* The placement hints are only preferences, fall back to any region with the required capabilities */
+        if (flags == required) {
+            return MR_NULL;
+        }
+        flags = required;
+    }
+}
+
+/**
+ * @brief This function add a memory region to the heap.
+ *
+ * @param memory The memory of the region.
+ * @param size The size of the region.
+ * @param flags The flags of the region.
+ * @param priority The priority of the region, regions with a lower value are searched first.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @retval -7 region is too small.
+ *
+ * @note The flags describe the capabilities of the region (MR_HEAP_DMA, MR_HEAP_FAST, MR_HEAP_BULK).
+ */
+int mr_heap_add_region(void *memory, size_t size, int flags, int priority)
+{
+    uint8_t *start = (uint8_t *)MR_ALIGN_UP((uintptr_t)memory, sizeof(void *));
+    uint8_t *end = (uint8_t *)MR_ALIGN_DOWN((uintptr_t)memory + size, 4);
+    struct heap_region *region = (struct heap_region *)start;
+
+    MR_ASSERT(memory != MR_NULL);
+
+    if ((end <= start) || ((size_t)(end - start) <= MR_ALIGN_UP(sizeof(struct heap_region), sizeof(void *)))) {
+        return MR_EINVAL;
+    }
+
+    /* Initialize the region */
+    region->next = MR_NULL;
+    region->start = start + MR_ALIGN_UP(sizeof(struct heap_region), sizeof(void *));
+    region->end = end;
+    region->flags = flags;
+    region->priority = priority;
+    if (heap_region_init(region) != MR_EOK) {
+        return MR_EINVAL;
+    }
+
+    /* Insert the region in priority order, after the regions with the same priority */
+    mr_interrupt_disable();
+    struct heap_region **link = &heap_region_list;
+    while ((*link != MR_NULL) && ((*link)->priority <= priority)) {
+        link = &(*link)->next;
+    }
+    region->next = *link;
+    *link = region;
     mr_interrupt_enable();
-    return memory;
+    return MR_EOK;
+}
+
+/**
+ * @brief This function initialize the heap.
+ */
+static void mr_heap_init(void)
+{
+    mr_heap_add_region(heap_mem, sizeof(heap_mem), MR_CFG_HEAP_FLAGS, 0);
+}
+MR_INIT_BOARD_EXPORT(mr_heap_init);
+
+#ifdef MR_USING_HEAP_SLAB
+#ifndef MR_CFG_HEAP_SLAB_MAX_SIZE
+#define MR_CFG_HEAP_SLAB_MAX_SIZE       (64)
+#endif /* MR_CFG_HEAP_SLAB_MAX_SIZE */
+#ifndef MR_CFG_HEAP_SLAB_OBJS_NUM
+#define MR_CFG_HEAP_SLAB_OBJS_NUM       (4)
+#endif /* MR_CFG_HEAP_SLAB_OBJS_NUM */
+#define MR_HEAP_SLAB_MIN_SIZE           (8)                         /**< Smallest size class */
+
+/**
+ * @brief Slab size class structure.
+ *
+ * @note Free objects are linked by their block header, an allocated object points its header to the free list head,
+ *       so that it can be told apart from a heap block (whose next is always null) in constant time. Pages taken
+ *       from the heap are kept by the slab.
+ */
+static struct heap_slab
+{
+    struct mr_heap_block free;                                      /**< Free object list head */
+    size_t total;                                                   /**< Total objects */
+    size_t used;                                                    /**< Used objects */
+    size_t peak;                                                    /**< Peak used objects */
+    size_t fails;                                                   /**< Refill failures */
+} heap_slab[8] = {0};                                               /**< 8, 16, 32, ... 1024 bytes */
+
+MR_INLINE size_t heap_slab_index(size_t size)
+{
+    size_t index = 0;
+
+    for (size = (size - 1) / MR_HEAP_SLAB_MIN_SIZE; size != 0; size >>= 1) {
+        index++;
+    }
+    return index;
+}
+
+static int heap_slab_refill(struct heap_slab *slab, size_t size)
+{
+    size_t objsz = sizeof(struct mr_heap_block) + size;
+
+    /* Take a page from the heap */
+    struct mr_heap_block *page = heap_allocate_block(objsz * MR_CFG_HEAP_SLAB_OBJS_NUM, MR_HEAP_ALIGN_MIN, 0);
+    if (page == MR_NULL) {
+        slab->fails++;
+        return MR_ENOMEM;
+    }
+
+    /* Carve the page into objects */
+    for (size_t i = 0; i < MR_CFG_HEAP_SLAB_OBJS_NUM; i++) {
+        struct mr_heap_block *block = (struct mr_heap_block *)((uint8_t *)heap_block_to_memory(page) + i * objsz);
+
+        block->size = size;
+        block->allocated = MR_HEAP_BLOCK_FREE;
+        block->next = slab->free.next;
+        slab->free.next = block;
+    }
+    slab->total += MR_CFG_HEAP_SLAB_OBJS_NUM;
+    return MR_EOK;
+}
+
+static struct mr_heap_block *heap_slab_take(size_t size)
+{
+    size_t index = heap_slab_index(size);
+    struct heap_slab *slab = &heap_slab[index];
+
+    /* Refill the slab when it runs out of objects */
+    if ((slab->free.next == MR_NULL) &&
+        (heap_slab_refill(slab, MR_HEAP_SLAB_MIN_SIZE << index) != MR_EOK)) {
+        return MR_NULL;
+    }
+
+    /* Take the first object */
+    struct mr_heap_block *block = slab->free.next;
+    slab->free.next = block->next;
+    block->next = &slab->free;
+    block->allocated = MR_HEAP_BLOCK_ALLOCATED;
+    slab->used++;
+    if (slab->used > slab->peak) {
+        slab->peak = slab->used;
+    }
+    return block;
+}
+
+static void heap_slab_release(struct mr_heap_block *block)
+{
+    struct heap_slab *slab = MR_CONTAINER_OF(block->next, struct heap_slab, free);
+
+    /* Put the object back to the free list */
+    block->allocated = MR_HEAP_BLOCK_FREE;
+    block->next = slab->free.next;
+    slab->free.next = block;
+    slab->used--;
+}
+
+/**
+ * @brief This function get the statistics of a slab size class.
+ *
+ * @param index The index of the size class (the size is 8 << index).
+ * @param stats The statistics.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @retval -7 index is out of range.
+ */
+int mr_heap_slab_get_stats(size_t index, struct mr_heap_slab_stats *stats)
+{
+    MR_ASSERT(stats != MR_NULL);
+
+    if ((index >= MR_ARRAY_NUM(heap_slab)) || ((MR_HEAP_SLAB_MIN_SIZE << index) > MR_CFG_HEAP_SLAB_MAX_SIZE)) {
+        return MR_EINVAL;
+    }
+
+    mr_interrupt_disable();
+    stats->size = MR_HEAP_SLAB_MIN_SIZE << index;
+    stats->total = heap_slab[index].total;
+    stats->used = heap_slab[index].used;
+    stats->peak = heap_slab[index].peak;
+    stats->fails = heap_slab[index].fails;
+    mr_interrupt_enable();
+    return MR_EOK;
+}
+#endif /* MR_USING_HEAP_SLAB */
+
+#ifdef MR_USING_HEAP_STATS
+#ifndef MR_CFG_HEAP_TAG_NUM
+#define MR_CFG_HEAP_TAG_NUM             (8)
+#endif /* MR_CFG_HEAP_TAG_NUM */
+
+/**
+ * @brief Heap statistics structure.
+ */
+static struct heap_stats
+{
+    size_t used;                                                    /**< Used bytes */
+    size_t peak;                                                    /**< Peak used bytes */
+    size_t fails;                                                   /**< Allocation failures */
+    const char *tag;                                                /**< Current tag */
+} heap_stats = {0};
+
+/**
+ * @brief Heap tags, the first one counts the untagged allocations and the tags that did not fit in the table.
+ */
+static struct mr_heap_tag_stats heap_tag[MR_CFG_HEAP_TAG_NUM] = {0};
+
+static void heap_stats_alloc(struct mr_heap_block *block)
+{
+    struct mr_heap_tag_stats *tag = &heap_tag[block->tag];
+
+    heap_stats.used += block->size;
+    if (heap_stats.used > heap_stats.peak) {
+        heap_stats.peak = heap_stats.used;
+    }
+    tag->used += block->size;
+    tag->count++;
+    if (tag->used > tag->peak) {
+        tag->peak = tag->used;
+    }
+}
+
+static void heap_stats_free(struct mr_heap_block *block)
+{
+    struct mr_heap_tag_stats *tag = &heap_tag[block->tag];
+
+    heap_stats.used -= block->size;
+    tag->used -= block->size;
+    tag->count--;
+}
+
+static uint32_t heap_tag_index(const char *tag)
+{
+    /* Search for the tag, a new one takes a free slot on its first allocation */
+    if (tag != MR_NULL) {
+        for (uint32_t index = 1; index < MR_CFG_HEAP_TAG_NUM; index++) {
+            if (heap_tag[index].name == MR_NULL) {
+                heap_tag[index].name = tag;
+                return index;
+            }
+            if (strncmp(heap_tag[index].name, tag, MR_CFG_DEV_NAME_LEN) == 0) {
+                return index;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief This function set the tag of the following allocations.
+ *
+ * @param tag The tag (a device name or call-site ID), MR_NULL for untagged.
+ *
+ * @return The previous tag.
+ *
+ * @note The tag string must remain valid, tags are compared by their first MR_CFG_DEV_NAME_LEN characters.
+ *       A tag takes a slot only when an allocation is made with it.
+ *       The tag is global, allocations made from an interrupt while it is set are charged to it as well.
+ */
+const char *mr_heap_set_tag(const char *tag)
+{
+    const char *prev = heap_stats.tag;
+
+    heap_stats.tag = tag;
+    return prev;
+}
+
+/**
+ * @brief This function get the statistics of the heap.
+ *
+ * @param stats The statistics.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @note The free blocks of all regions are walked with interrupts disabled.
+ */
+int mr_heap_get_stats(struct mr_heap_stats *stats)
+{
+    size_t max_free_sum = 0;
+
+    MR_ASSERT(stats != MR_NULL);
+
+    memset(stats, 0, sizeof(*stats));
+
+    mr_interrupt_disable();
+    for (struct heap_region *region = heap_region_list; region != MR_NULL; region = region->next) {
+        size_t max_free = heap_region_get_free(region, stats);
+
+        stats->total += region->end - region->start;
+        stats->max_free = MR_MAX(stats->max_free, max_free);
+        max_free_sum += max_free;
+    }
+    stats->used = heap_stats.used;
+    stats->peak = heap_stats.peak;
+    stats->fails = heap_stats.fails;
+    mr_interrupt_enable();
+
+    /* The fragmentation is the percentage of the free memory that is not in the largest free block of its region */
+    if (stats->free != 0) {
+        stats->frag = (uint32_t)(100 - ((max_free_sum * 100) / stats->free));
+    }
+    return MR_EOK;
+}
+
+/**
+ * @brief This function get the statistics of a heap tag.
+ *
+ * @param index The index of the tag (0 is untagged).
+ * @param stats The statistics.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @retval -7 index is out of range.
+ */
+int mr_heap_get_tag_stats(size_t index, struct mr_heap_tag_stats *stats)
+{
+    MR_ASSERT(stats != MR_NULL);
+
+    if ((index >= MR_CFG_HEAP_TAG_NUM) || ((index != 0) && (heap_tag[index].name == MR_NULL))) {
+        return MR_EINVAL;
+    }
+
+    mr_interrupt_disable();
+    *stats = heap_tag[index];
+    mr_interrupt_enable();
+    return MR_EOK;
+}
+#endif /* MR_USING_HEAP_STATS */
+
+static int heap_resize_block(struct mr_heap_block *block, size_t size)
+{
+#ifdef MR_USING_HEAP_SLAB
+    /* Slab objects are kept while the size fits in their class */
+    if (block->next != MR_NULL) {
+        return (size <= block->size) ? MR_EOK : MR_ENOMEM;
+    }
+#endif /* MR_USING_HEAP_SLAB */
+
+    struct heap_region *region = heap_region_find(block);
+    size_t old_size = block->size;
+
+    if (region == MR_NULL) {
+        return MR_EINVAL;
+    }
+
+    /* Grow by taking the free next block, shrink by splitting off the tail */
+    heap_merge_next_block(region, block);
+    if (block->size < size) {
+        heap_split_block(region, block, old_size);
+        return MR_ENOMEM;
+    }
+    heap_split_block(region, block, size);
+    return MR_EOK;
+}
+
+/**
+ * @brief This function allocate memory.
+ *
+ * @param size The size of the memory.
+ *
+ * @return A pointer to the allocated memory.
+ */
+MR_WEAK void *mr_malloc(size_t size)
+{
+    return mr_malloc_ex(size, 0);
+}
+
+static void *heap_malloc(size_t size, size_t align, int flags)
+{
+#ifdef MR_USING_TRACE
+    uint32_t start = mr_cycle_get();
+#endif /* MR_USING_TRACE */
+
+    /* Check size */
+    if ((size == 0) || (size > (UINT32_MAX >> 1))) {
+        return MR_NULL;
+    }
+
+    /* Align the size to the next multiple of 4 bytes, a free block must hold its list links */
+    size = MR_ALIGN_UP(MR_MAX(size, sizeof(struct mr_heap_block *)), MR_HEAP_ALIGN_MIN);
+
+    mr_interrupt_disable();
+
+#ifdef MR_USING_HEAP_SLAB
+    /* Small requests without placement hints are served from the slab */
+    struct mr_heap_block *block = ((flags == 0) && (align <= MR_HEAP_ALIGN_MIN) &&
+                                   (size <= MR_CFG_HEAP_SLAB_MAX_SIZE)) ? heap_slab_take(size) : MR_NULL;
+    if (block == MR_NULL) {
+        block = heap_allocate_block(size, align, flags);
+    }
+#else
+    struct mr_heap_block *block = heap_allocate_block(size, align, flags);
+#endif /* MR_USING_HEAP_SLAB */
+
+#ifdef MR_USING_HEAP_STATS
+    if (block != MR_NULL) {
+        block->tag = heap_tag_index(heap_stats.tag);
+        heap_stats_alloc(block);
+    } else {
+        heap_stats.fails++;
+    }
+#endif /* MR_USING_HEAP_STATS */
+
+    mr_interrupt_enable();
+#ifdef MR_USING_TRACE
+    mr_trace(MR_TRACE_MALLOC,
+             start,
+             (block != MR_NULL) ? heap_block_to_memory(block) : MR_NULL,
+             (int)size,
+             (block != MR_NULL) ? MR_EOK : MR_ENOMEM);
+#endif /* MR_USING_TRACE */
+    return (block != MR_NULL) ? heap_block_to_memory(block) : MR_NULL;
+}
+
+/**
+ * @brief This function allocate memory with placement hints.
+ *
+ * @param size The size of the memory.
+ * @param flags The placement flags.
+ *
+ * @return A pointer to the allocated memory.
+ *
+ * @note MR_HEAP_DMA is a requirement, MR_HEAP_FAST and MR_HEAP_BULK are preferences that fall back to any region.
+ */
+MR_WEAK void *mr_malloc_ex(size_t size, int flags)
+{
+    return heap_malloc(size, MR_HEAP_ALIGN_MIN, flags);
+}
+
+/**
+ * @brief This function allocate aligned memory.
+ *
+ * @param size The size of the memory.
+ * @param align The alignment of the memory (a power of 2).
+ * @param flags The placement flags.
+ *
+ * @return A pointer to the allocated memory.
+ *
+ * @note The memory before and after the aligned memory is returned to the heap. The alignment is not kept if
+ *       mr_realloc has to move the memory.
+ */
+MR_WEAK void *mr_malloc_aligned(size_t size, size_t align, int flags)
+{
+    /* Check alignment */
+    if ((align == 0) || ((align & (align - 1)) != 0)) {
+        return MR_NULL;
+    }
+
+    return heap_malloc(size, align, flags);
 }
 
 /**
@@ -141,24 +992,54 @@ MR_WEAK void *mr_malloc(size_t size)
  */
 MR_WEAK void mr_free(void *memory)
 {
+#ifdef MR_USING_TRACE
+    uint32_t start = mr_cycle_get();
+#endif /* MR_USING_TRACE */
+
     if (memory != MR_NULL) {
-        struct mr_heap_block *block = (struct mr_heap_block *)((uint8_t *)memory -
-                                                               sizeof(struct mr_heap_block));
+        struct mr_heap_block *block = heap_memory_to_block(memory);
 
         mr_interrupt_disable();
 
         /* Check the block */
         if (block->allocated == MR_HEAP_BLOCK_ALLOCATED && block->size != 0) {
-            block->allocated = MR_HEAP_BLOCK_FREE;
-
-            /* Insert the free block */
-            heap_insert_block(block);
+#ifdef MR_USING_HEAP_STATS
+            heap_stats_free(block);
+#endif /* MR_USING_HEAP_STATS */
+#ifdef MR_USING_HEAP_SLAB
+            /* Only slab objects are linked when allocated */
+            if (block->next != MR_NULL) {
+                heap_slab_release(block);
+                mr_interrupt_enable();
+#ifdef MR_USING_TRACE
+                mr_trace(MR_TRACE_FREE, start, memory, 0, MR_EOK);
+#endif /* MR_USING_TRACE */
+                return;
+            }
+#endif /* MR_USING_HEAP_SLAB */
+            struct heap_region *region = heap_region_find(block);
+            if (region != MR_NULL) {
+                heap_release_block(region, block);
+            }
         }
 
         mr_interrupt_enable();
+#ifdef MR_USING_TRACE
+        mr_trace(MR_TRACE_FREE, start, memory, 0, MR_EOK);
+#endif /* MR_USING_TRACE */
     }
 }
 
+/**
+ * @brief This function free aligned memory.
+ *
+ * @param memory The memory to free.
+ */
+MR_WEAK void mr_free_aligned(void *memory)
+{
+    mr_free(memory);
+}
+
 /**
  * @brief This function get the usable size of the memory.
  *
@@ -170,8 +1051,7 @@ MR_WEAK size_t mr_malloc_usable_size(void *memory)
 {
     if (memory != MR_NULL) {
         /* Get the block information */
-        struct mr_heap_block *block = (struct mr_heap_block *)((uint8_t *)memory -
-                                                               sizeof(struct mr_heap_block));
+        struct mr_heap_block *block = heap_memory_to_block(memory);
         return block->size;
     }
     return 0;
@@ -203,14 +1083,64 @@ MR_WEAK void *mr_calloc(size_t num, size_t size)
  * @param size The size of the memory.
  *
  * @return A pointer to the allocated memory.
+ *
+ * @note The memory is resized in place when possible, otherwise it is moved to a region with the same capabilities.
  */
 MR_WEAK void *mr_realloc(void *memory, size_t size)
 {
-    size_t old_size = mr_malloc_usable_size(memory);
+    if (memory == MR_NULL) {
+        return mr_malloc(size);
+    }
+    if (size == 0) {
+        mr_free(memory);
+        return MR_NULL;
+    }
+    if (size > (UINT32_MAX >> 1)) {
+        return MR_NULL;
+    }
+
+    struct mr_heap_block *block = heap_memory_to_block(memory);
+    size_t old_size = block->size;
+    int flags = 0;
 
-    void *new_memory = mr_malloc(size);
+    mr_interrupt_disable();
+
+    /* Resize in place */
+#ifdef MR_USING_HEAP_STATS
+    heap_stats_free(block);
+    int ret = heap_resize_block(block, MR_ALIGN_UP(MR_MAX(size, sizeof(struct mr_heap_block *)), MR_HEAP_ALIGN_MIN));
+    heap_stats_alloc(block);
+#else
+    int ret = heap_resize_block(block, MR_ALIGN_UP(MR_MAX(size, sizeof(struct mr_heap_block *)), MR_HEAP_ALIGN_MIN));
+#endif /* MR_USING_HEAP_STATS */
+    if (ret == MR_EOK) {
+        mr_interrupt_enable();
+        return memory;
+    }
+
+    /* Keep the memory in a region with the same capabilities, slab objects have no placement */
+    if (block->next == MR_NULL) {
+        struct heap_region *region = heap_region_find(block);
+        if (region != MR_NULL) {
+            flags = region->flags & MR_HEAP_DMA;
+        }
+    }
+
+    mr_interrupt_enable();
+
+    void *new_memory = mr_malloc_ex(size, flags);
     if (new_memory != MR_NULL) {
-        memcpy(new_memory, memory, old_size);
+#ifdef MR_USING_HEAP_STATS
+        struct mr_heap_block *new_block = heap_memory_to_block(new_memory);
+
+        /* Keep the tag of the memory */
+        mr_interrupt_disable();
+        heap_stats_free(new_block);
+        new_block->tag = block->tag;
+        heap_stats_alloc(new_block);
+        mr_interrupt_enable();
+#endif /* MR_USING_HEAP_STATS */
+        memcpy(new_memory, memory, MR_MIN(old_size, size));
         mr_free(memory);
     }
     return new_memory;
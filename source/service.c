@@ -81,6 +81,18 @@ MR_WEAK void mr_delay_ms(uint32_t ms)
     }
 }
 
+/**
+ * @brief This function get the cycle counter.
+ *
+ * @return The cycle counter.
+ *
+ * @note The default counter is always 0, override it with a free-running counter (e.g. the DWT cycle counter).
+ */
+MR_WEAK uint32_t mr_cycle_get(void)
+{
+    return 0;
+}
+
 /**
  * @brief This function printf output.
  *
@@ -197,22 +209,132 @@ const char *mr_strflags(int flags)
     return str;
 }
 
+#ifdef MR_USING_RINGBUF_SPSC
+#if defined(__GNUC__)
+#define MR_RINGBUF_LOAD(index)          __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define MR_RINGBUF_STORE(index, value)  __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#elif (defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__))
+#include <stdatomic.h>
+#define MR_RINGBUF_LOAD(index)          ringbuf_load_acquire(&(index))
+#define MR_RINGBUF_STORE(index, value)  ringbuf_store_release(&(index), (value))
+
+MR_INLINE size_t ringbuf_load_acquire(size_t *index)
+{
+    size_t value = *(volatile size_t *)index;
+
+    atomic_thread_fence(memory_order_acquire);
+    return value;
+}
+
+MR_INLINE void ringbuf_store_release(size_t *index, size_t value)
+{
+    atomic_thread_fence(memory_order_release);
+    *(volatile size_t *)index = value;
+}
+#else
+#error "MR_USING_RINGBUF_SPSC requires GCC-compatible or C11 atomics"
+#endif /* defined(__GNUC__) */
+#else
+#define MR_RINGBUF_LOAD(index)          (index)
+#define MR_RINGBUF_STORE(index, value)  ((index) = (value))
+#endif /* MR_USING_RINGBUF_SPSC */
+
+#ifdef MR_USING_RINGBUF_POW2
+/**
+ * @brief Ringbuffer indices run freely and are masked by the power of two buffer size, the buf size is their
+ *        difference, and each index is only written by its own side.
+ */
+MR_INLINE size_t ringbuf_index_offset(struct mr_ringbuf *ringbuf, size_t index)
+{
+    return index & (ringbuf->size - 1);
+}
+
+MR_INLINE size_t ringbuf_index_add(struct mr_ringbuf *ringbuf, size_t index, size_t count)
+{
+    (void)ringbuf;
+    return index + count;
+}
+
+MR_INLINE size_t ringbuf_index_sub(struct mr_ringbuf *ringbuf, size_t index, size_t count)
+{
+    (void)ringbuf;
+    return index - count;
+}
+
+MR_INLINE size_t ringbuf_data_size(struct mr_ringbuf *ringbuf, size_t read_index, size_t write_index)
+{
+    (void)ringbuf;
+    return write_index - read_index;
+}
+#else
+/**
+ * @brief Ringbuffer indices run over twice the buffer size, so that a full ringbuffer can be told apart from an
+ *        empty one, and each index is only written by its own side.
+ */
+MR_INLINE size_t ringbuf_index_offset(struct mr_ringbuf *ringbuf, size_t index)
+{
+    return (index < ringbuf->size) ? index : (index - ringbuf->size);
+}
+
+MR_INLINE size_t ringbuf_index_add(struct mr_ringbuf *ringbuf, size_t index, size_t count)
+{
+    index += count;
+    return (index < (ringbuf->size << 1)) ? index : (index - (ringbuf->size << 1));
+}
+
+MR_INLINE size_t ringbuf_index_sub(struct mr_ringbuf *ringbuf, size_t index, size_t count)
+{
+    return (index >= count) ? (index - count) : (index + (ringbuf->size << 1) - count);
+}
+
+MR_INLINE size_t ringbuf_data_size(struct mr_ringbuf *ringbuf, size_t read_index, size_t write_index)
+{
+    return (write_index >= read_index) ? (write_index - read_index) : ((ringbuf->size << 1) - read_index + write_index);
+}
+#endif /* MR_USING_RINGBUF_POW2 */
+
+MR_INLINE void ringbuf_copy_out(struct mr_ringbuf *ringbuf, size_t index, uint8_t *buffer, size_t size)
+{
+    size_t offset = ringbuf_index_offset(ringbuf, index);
+    size_t count = MR_MIN(size, ringbuf->size - offset);
+
+    memcpy(buffer, &ringbuf->buffer[offset], count);
+    memcpy(&buffer[count], &ringbuf->buffer[0], size - count);
+}
+
+MR_INLINE void ringbuf_copy_in(struct mr_ringbuf *ringbuf, size_t index, const uint8_t *buffer, size_t size)
+{
+    size_t offset = ringbuf_index_offset(ringbuf, index);
+    size_t count = MR_MIN(size, ringbuf->size - offset);
+
+    memcpy(&ringbuf->buffer[offset], buffer, count);
+    memcpy(&ringbuf->buffer[0], &buffer[count], size - count);
+}
+
 /**
  * @brief This function initialize the ringbuffer.
  *
  * @param ringbuf The ringbuffer to initialize.
  * @param pool The pool of buf.
  * @param size The size of the pool.
+ *
+ * @note With MR_USING_RINGBUF_POW2 the size is rounded down to a power of two, since the pool can not grow, the
+ *       actual size is returned by mr_ringbuf_get_bufsz().
  */
 void mr_ringbuf_init(struct mr_ringbuf *ringbuf, void *pool, size_t size)
 {
     MR_ASSERT(ringbuf != MR_NULL);
     MR_ASSERT((pool != MR_NULL) || (size == 0));
 
+#ifdef MR_USING_RINGBUF_POW2
+    /* Round down to a power of two, the rest of the pool is not used */
+    while ((size & (size - 1)) != 0) {
+        size &= size - 1;
+    }
+#endif /* MR_USING_RINGBUF_POW2 */
+
     ringbuf->read_index = 0;
     ringbuf->write_index = 0;
-    ringbuf->read_mirror = 0;
-    ringbuf->write_mirror = 0;
     ringbuf->size = size;
     ringbuf->buffer = pool;
 }
@@ -224,11 +346,27 @@ void mr_ringbuf_init(struct mr_ringbuf *ringbuf, void *pool, size_t size)
  * @param size The size of the memory.
  *
  * @return MR_ERR_OK on success, otherwise an error code.
+ *
+ * @note With MR_USING_RINGBUF_POW2 the size is rounded up to a power of two, so that at least the size fits, the
+ *       actual size is returned by mr_ringbuf_get_bufsz().
  */
 int mr_ringbuf_allocate(struct mr_ringbuf *ringbuf, size_t size)
 {
     MR_ASSERT(ringbuf != MR_NULL);
 
+#ifdef MR_USING_RINGBUF_POW2
+    /* Round up to a power of two, so that the indices can be masked */
+    size_t pow2 = 1;
+
+    while ((pow2 < size) && (pow2 != 0)) {
+        pow2 <<= 1;
+    }
+    if (pow2 == 0) {
+        return MR_ENOMEM;
+    }
+    size = (size == 0) ? 0 : pow2;
+#endif /* MR_USING_RINGBUF_POW2 */
+
     if (size == mr_ringbuf_get_bufsz(ringbuf)) {
         mr_ringbuf_reset(ringbuf);
         return MR_EOK;
@@ -272,8 +410,6 @@ void mr_ringbuf_reset(struct mr_ringbuf *ringbuf)
 
     ringbuf->read_index = 0;
     ringbuf->write_index = 0;
-    ringbuf->read_mirror = 0;
-    ringbuf->write_mirror = 0;
 }
 
 /**
@@ -287,20 +423,7 @@ size_t mr_ringbuf_get_data_size(struct mr_ringbuf *ringbuf)
 {
     MR_ASSERT(ringbuf != MR_NULL);
 
-    /* Empty or full according to the mirror flag */
-    if (ringbuf->read_index == ringbuf->write_index) {
-        if (ringbuf->read_mirror == ringbuf->write_mirror) {
-            return 0;
-        } else {
-            return ringbuf->size;
-        }
-    }
-
-    if (ringbuf->write_index > ringbuf->read_index) {
-        return ringbuf->write_index - ringbuf->read_index;
-    } else {
-        return ringbuf->size - ringbuf->read_index + ringbuf->write_index;
-    }
+    return ringbuf_data_size(ringbuf, MR_RINGBUF_LOAD(ringbuf->read_index), MR_RINGBUF_LOAD(ringbuf->write_index));
 }
 
 /**
@@ -344,19 +467,17 @@ size_t mr_ringbuf_pop(struct mr_ringbuf *ringbuf, uint8_t *data)
     MR_ASSERT(ringbuf != MR_NULL);
     MR_ASSERT(data != MR_NULL);
 
+    size_t read_index = ringbuf->read_index;
+
     /* Get the buf size */
-    if (mr_ringbuf_get_data_size(ringbuf) == 0) {
+    if (read_index == MR_RINGBUF_LOAD(ringbuf->write_index)) {
         return 0;
     }
 
-    *data = ringbuf->buffer[ringbuf->read_index];
+    *data = ringbuf->buffer[ringbuf_index_offset(ringbuf, read_index)];
 
-    if (ringbuf->read_index == ringbuf->size - 1) {
-        ringbuf->read_mirror = ~ringbuf->read_mirror;
-        ringbuf->read_index = 0;
-    } else {
-        ringbuf->read_index++;
-    }
+    /* Release the space to the producer */
+    MR_RINGBUF_STORE(ringbuf->read_index, ringbuf_index_add(ringbuf, read_index, 1));
     return 1;
 }
 
@@ -376,8 +497,10 @@ size_t mr_ringbuf_read(struct mr_ringbuf *ringbuf, void *buffer, size_t size)
     MR_ASSERT(ringbuf != MR_NULL);
     MR_ASSERT((buffer != MR_NULL) || (size == 0));
 
+    size_t read_index = ringbuf->read_index;
+
     /* Get the buf size */
-    size_t data_size = mr_ringbuf_get_data_size(ringbuf);
+    size_t data_size = ringbuf_data_size(ringbuf, read_index, MR_RINGBUF_LOAD(ringbuf->write_index));
     if (data_size == 0) {
         return 0;
     }
@@ -388,19 +511,10 @@ size_t mr_ringbuf_read(struct mr_ringbuf *ringbuf, void *buffer, size_t size)
     }
 
     /* Copy the buf from the ringbuf to the buffer */
-    if ((ringbuf->size - ringbuf->read_index) > size) {
-        memcpy(read_buffer, &ringbuf->buffer[ringbuf->read_index], size);
-        ringbuf->read_index += size;
-        return size;
-    }
+    ringbuf_copy_out(ringbuf, read_index, read_buffer, size);
 
-    memcpy(read_buffer, &ringbuf->buffer[ringbuf->read_index], ringbuf->size - ringbuf->read_index);
-    memcpy(&read_buffer[ringbuf->size - ringbuf->read_index],
-           &ringbuf->buffer[0],
-           size - (ringbuf->size - ringbuf->read_index));
-
-    ringbuf->read_mirror = ~ringbuf->read_mirror;
-    ringbuf->read_index = size - (ringbuf->size - ringbuf->read_index);
+    /* Release the space to the producer */
+    MR_RINGBUF_STORE(ringbuf->read_index, ringbuf_index_add(ringbuf, read_index, size));
     return size;
 }
 
@@ -416,19 +530,17 @@ size_t mr_ringbuf_push(struct mr_ringbuf *ringbuf, uint8_t data)
 {
     MR_ASSERT(ringbuf != MR_NULL);
 
+    size_t write_index = ringbuf->write_index;
+
     /* Get the space size */
-    if (mr_ringbuf_get_space_size(ringbuf) == 0) {
+    if (ringbuf_data_size(ringbuf, MR_RINGBUF_LOAD(ringbuf->read_index), write_index) == ringbuf->size) {
         return 0;
     }
 
-    ringbuf->buffer[ringbuf->write_index] = data;
+    ringbuf->buffer[ringbuf_index_offset(ringbuf, write_index)] = data;
 
-    if (ringbuf->write_index == ringbuf->size - 1) {
-        ringbuf->write_mirror = ~ringbuf->write_mirror;
-        ringbuf->write_index = 0;
-    } else {
-        ringbuf->write_index++;
-    }
+    /* Publish the data to the consumer */
+    MR_RINGBUF_STORE(ringbuf->write_index, ringbuf_index_add(ringbuf, write_index, 1));
     return 1;
 }
 
@@ -439,39 +551,32 @@ size_t mr_ringbuf_push(struct mr_ringbuf *ringbuf, uint8_t data)
  * @param data The buf to be pushed.
  *
  * @return The size of the actual write.
+ *
+ * @note In lock-free mode the read index belongs to the consumer, the data is dropped when the ringbuffer is full.
  */
 size_t mr_ringbuf_push_force(struct mr_ringbuf *ringbuf, uint8_t data)
 {
-    int state = 0;
-
+#ifdef MR_USING_RINGBUF_SPSC
+    return mr_ringbuf_push(ringbuf, data);
+#else
     MR_ASSERT(ringbuf != MR_NULL);
 
+    size_t write_index = ringbuf->write_index;
+
     /* Get the buffer size */
     if (mr_ringbuf_get_bufsz(ringbuf) == 0) {
         return 0;
     }
 
-    /* Get the space size */
-    if (mr_ringbuf_get_space_size(ringbuf) == 0) {
-        state = 1;
-    }
-
-    ringbuf->buffer[ringbuf->write_index] = data;
+    ringbuf->buffer[ringbuf_index_offset(ringbuf, write_index)] = data;
 
-    if (ringbuf->write_index == ringbuf->size - 1) {
-        ringbuf->write_mirror = ~ringbuf->write_mirror;
-        ringbuf->write_index = 0;
-        if (state == 1) {
-            ringbuf->read_mirror = ~ringbuf->read_mirror;
-            ringbuf->read_index = ringbuf->write_index;
-        }
-    } else {
-        ringbuf->write_index++;
-        if (state == 1) {
-            ringbuf->read_index = ringbuf->write_index;
-        }
+    /* If the ringbuffer is full, the oldest buf is discarded */
+    if (ringbuf_data_size(ringbuf, ringbuf->read_index, write_index) == ringbuf->size) {
+        ringbuf->read_index = ringbuf_index_add(ringbuf, ringbuf->read_index, 1);
     }
+    ringbuf->write_index = ringbuf_index_add(ringbuf, write_index, 1);
     return 1;
+#endif /* MR_USING_RINGBUF_SPSC */
 }
 
 /**
@@ -490,8 +595,11 @@ size_t mr_ringbuf_write(struct mr_ringbuf *ringbuf, const void *buffer, size_t s
     MR_ASSERT(ringbuf != MR_NULL);
     MR_ASSERT((buffer != MR_NULL) || (size == 0));
 
+    size_t write_index = ringbuf->write_index;
+
     /* Get the space size */
-    size_t space_size = mr_ringbuf_get_space_size(ringbuf);
+    size_t space_size = ringbuf->size -
+                        ringbuf_data_size(ringbuf, MR_RINGBUF_LOAD(ringbuf->read_index), write_index);
     if (space_size == 0) {
         return 0;
     }
@@ -502,22 +610,10 @@ size_t mr_ringbuf_write(struct mr_ringbuf *ringbuf, const void *buffer, size_t s
     }
 
     /* Copy the buf from the buffer to the ringbuf */
-    if ((ringbuf->size - ringbuf->write_index) > size) {
-        memcpy(&ringbuf->buffer[ringbuf->write_index], write_buffer, size);
-        ringbuf->write_index += size;
-
-        return size;
-    }
+    ringbuf_copy_in(ringbuf, write_index, write_buffer, size);
 
-    memcpy(&ringbuf->buffer[ringbuf->write_index],
-           write_buffer,
-           ringbuf->size - ringbuf->write_index);
-    memcpy(&ringbuf->buffer[0],
-           &write_buffer[ringbuf->size - ringbuf->write_index],
-           size - (ringbuf->size - ringbuf->write_index));
-
-    ringbuf->write_mirror = ~ringbuf->write_mirror;
-    ringbuf->write_index = size - (ringbuf->size - ringbuf->write_index);
+    /* Publish the data to the consumer */
+    MR_RINGBUF_STORE(ringbuf->write_index, ringbuf_index_add(ringbuf, write_index, size));
     return size;
 }
 
@@ -529,9 +625,14 @@ size_t mr_ringbuf_write(struct mr_ringbuf *ringbuf, const void *buffer, size_t s
  * @param size The size of write.
  *
  * @return The size of the actual write.
+ *
+ * @note In lock-free mode the read index belongs to the consumer, the data that does not fit is dropped.
  */
 size_t mr_ringbuf_write_force(struct mr_ringbuf *ringbuf, const void *buffer, size_t size)
 {
+#ifdef MR_USING_RINGBUF_SPSC
+    return mr_ringbuf_write(ringbuf, buffer, size);
+#else
     uint8_t *write_buffer = (uint8_t *)buffer;
 
     MR_ASSERT(ringbuf != MR_NULL);
@@ -543,6 +644,7 @@ size_t mr_ringbuf_write_force(struct mr_ringbuf *ringbuf, const void *buffer, si
 
     /* Get the space size */
     size_t space_size = mr_ringbuf_get_space_size(ringbuf);
+    size_t write_index = ringbuf->write_index;
 
     /* If the buf exceeds the buffer space_size, the front buf is discarded */
     if (size > ringbuf->size) {
@@ -551,35 +653,286 @@ size_t mr_ringbuf_write_force(struct mr_ringbuf *ringbuf, const void *buffer, si
     }
 
     /* Copy the buf from the buffer to the ringbuf */
-    if ((ringbuf->size - ringbuf->write_index) > size) {
-        memcpy(&ringbuf->buffer[ringbuf->write_index], write_buffer, size);
-        ringbuf->write_index += size;
-        if (size > space_size) {
-            ringbuf->read_index = ringbuf->write_index;
-        }
-        return size;
+    ringbuf_copy_in(ringbuf, write_index, write_buffer, size);
+    ringbuf->write_index = ringbuf_index_add(ringbuf, write_index, size);
+
+    /* If the ringbuffer overflows, the oldest buf is discarded */
+    if (size > space_size) {
+        ringbuf->read_index = ringbuf_index_sub(ringbuf, ringbuf->write_index, ringbuf->size);
     }
+    return size;
+#endif /* MR_USING_RINGBUF_SPSC */
+}
+
+MR_INLINE size_t ringbuf_get_span(struct mr_ringbuf *ringbuf,
+                                  size_t index,
+                                  size_t size,
+                                  struct mr_ringbuf_span *span)
+{
+    size_t offset = ringbuf_index_offset(ringbuf, index);
 
-    memcpy(&ringbuf->buffer[ringbuf->write_index],
-           write_buffer,
-           ringbuf->size - ringbuf->write_index);
-    memcpy(&ringbuf->buffer[0],
-           &write_buffer[ringbuf->size - ringbuf->write_index],
-           size - (ringbuf->size - ringbuf->write_index));
+    /* The first span ends at the end of the buffer, the rest wraps to the beginning */
+    span[0].buffer = &ringbuf->buffer[offset];
+    span[0].size = MR_MIN(size, ringbuf->size - offset);
+    span[1].buffer = &ringbuf->buffer[0];
+    span[1].size = size - span[0].size;
+    return size;
+}
 
-    ringbuf->write_mirror = ~ringbuf->write_mirror;
-    ringbuf->write_index = size - (ringbuf->size - ringbuf->write_index);
+/**
+ * @brief This function peek the buf in the ringbuffer without copying it.
+ *
+ * @param ringbuf The ringbuffer to be peeked.
+ * @param span The spans (two entries) to be filled with the buf, the second one is used when the buf wraps.
+ * @param size The size of the peek.
+ *
+ * @return The size of the actual peek.
+ *
+ * @note The buf stays in the ringbuffer until it is released by mr_ringbuf_read_consume().
+ */
+size_t mr_ringbuf_read_peek(struct mr_ringbuf *ringbuf, struct mr_ringbuf_span *span, size_t size)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
+    MR_ASSERT(span != MR_NULL);
+
+    size_t read_index = ringbuf->read_index;
+
+    /* Adjust the number of bytes to peek if it exceeds the available buf */
+    size_t data_size = ringbuf_data_size(ringbuf, read_index, MR_RINGBUF_LOAD(ringbuf->write_index));
+    if (size > data_size) {
+        size = data_size;
+    }
+    return ringbuf_get_span(ringbuf, read_index, size, span);
+}
+
+/**
+ * @brief This function consume the buf from the ringbuffer.
+ *
+ * @param ringbuf The ringbuffer to be consumed.
+ * @param size The size of the consume.
+ *
+ * @return The size of the actual consume.
+ */
+size_t mr_ringbuf_read_consume(struct mr_ringbuf *ringbuf, size_t size)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
+
+    size_t read_index = ringbuf->read_index;
+
+    /* Adjust the number of bytes to consume if it exceeds the available buf */
+    size_t data_size = ringbuf_data_size(ringbuf, read_index, MR_RINGBUF_LOAD(ringbuf->write_index));
+    if (size > data_size) {
+        size = data_size;
+    }
+
+    /* Release the space to the producer */
+    MR_RINGBUF_STORE(ringbuf->read_index, ringbuf_index_add(ringbuf, read_index, size));
+    return size;
+}
+
+/**
+ * @brief This function reserve the space in the ringbuffer to be written in place.
+ *
+ * @param ringbuf The ringbuffer to be reserved.
+ * @param span The spans (two entries) to be filled with the space, the second one is used when the space wraps.
+ * @param size The size of the reserve.
+ *
+ * @return The size of the actual reserve.
+ *
+ * @note The buf written to the space is invisible to the reader until it is published by mr_ringbuf_write_commit().
+ */
+size_t mr_ringbuf_write_reserve(struct mr_ringbuf *ringbuf, struct mr_ringbuf_span *span, size_t size)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
+    MR_ASSERT(span != MR_NULL);
 
+    size_t write_index = ringbuf->write_index;
+
+    /* Adjust the number of bytes to reserve if it exceeds the available space */
+    size_t space_size = ringbuf->size -
+                        ringbuf_data_size(ringbuf, MR_RINGBUF_LOAD(ringbuf->read_index), write_index);
     if (size > space_size) {
-        if (ringbuf->write_index <= ringbuf->read_index) {
-            ringbuf->read_mirror = ~ringbuf->read_mirror;
-        }
+        size = space_size;
+    }
+    return ringbuf_get_span(ringbuf, write_index, size, span);
+}
+
+/**
+ * @brief This function commit the buf written to the reserved space of the ringbuffer.
+ *
+ * @param ringbuf The ringbuffer to be committed.
+ * @param size The size of the commit.
+ *
+ * @return The size of the actual commit.
+ */
+size_t mr_ringbuf_write_commit(struct mr_ringbuf *ringbuf, size_t size)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
 
-        ringbuf->read_index = ringbuf->write_index;
+    size_t write_index = ringbuf->write_index;
+
+    /* Adjust the number of bytes to commit if it exceeds the available space */
+    size_t space_size = ringbuf->size -
+                        ringbuf_data_size(ringbuf, MR_RINGBUF_LOAD(ringbuf->read_index), write_index);
+    if (size > space_size) {
+        size = space_size;
     }
+
+    /* Publish the data to the consumer */
+    MR_RINGBUF_STORE(ringbuf->write_index, ringbuf_index_add(ringbuf, write_index, size));
     return size;
 }
 
+MR_INLINE size_t ringbuf_get_record_size(struct mr_ringbuf *ringbuf, size_t index)
+{
+    uint8_t head[MR_RINGBUF_RECORD_HEAD];
+
+    /* The record head is the little-endian record size */
+    ringbuf_copy_out(ringbuf, index, head, sizeof(head));
+    return (size_t)head[0] | ((size_t)head[1] << 8);
+}
+
+MR_INLINE void ringbuf_put_record(struct mr_ringbuf *ringbuf, size_t index, const uint8_t *buffer, size_t size)
+{
+    uint8_t head[MR_RINGBUF_RECORD_HEAD] = {(uint8_t)size, (uint8_t)(size >> 8)};
+
+    ringbuf_copy_in(ringbuf, index, head, sizeof(head));
+    ringbuf_copy_in(ringbuf, ringbuf_index_add(ringbuf, index, sizeof(head)), buffer, size);
+}
+
+/**
+ * @brief This function get the size of the next record from the ringbuffer.
+ *
+ * @param ringbuf The ringbuffer to get the record size.
+ *
+ * @return The size of the next record, 0 if there is no record.
+ */
+size_t mr_ringbuf_get_record_size(struct mr_ringbuf *ringbuf)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
+
+    size_t read_index = ringbuf->read_index;
+
+    /* Get the buf size */
+    if (ringbuf_data_size(ringbuf, read_index, MR_RINGBUF_LOAD(ringbuf->write_index)) < MR_RINGBUF_RECORD_HEAD) {
+        return 0;
+    }
+    return ringbuf_get_record_size(ringbuf, read_index);
+}
+
+/**
+ * @brief This function reads a record from the ringbuffer.
+ *
+ * @param ringbuf The ringbuffer to be read.
+ * @param buffer The buffer to be read the record.
+ * @param size The size of the buffer.
+ *
+ * @return The size of the actual read, 0 if there is no record.
+ *
+ * @note The part of the record that exceeds the buffer is discarded.
+ */
+size_t mr_ringbuf_read_record(struct mr_ringbuf *ringbuf, void *buffer, size_t size)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
+    MR_ASSERT((buffer != MR_NULL) || (size == 0));
+
+    size_t read_index = ringbuf->read_index;
+
+    /* Get the buf size */
+    if (ringbuf_data_size(ringbuf, read_index, MR_RINGBUF_LOAD(ringbuf->write_index)) < MR_RINGBUF_RECORD_HEAD) {
+        return 0;
+    }
+
+    /* Copy the record from the ringbuf to the buffer */
+    size_t record_size = ringbuf_get_record_size(ringbuf, read_index);
+    size = MR_MIN(size, record_size);
+    ringbuf_copy_out(ringbuf, ringbuf_index_add(ringbuf, read_index, MR_RINGBUF_RECORD_HEAD), buffer, size);
+
+    /* Release the whole record to the producer */
+    MR_RINGBUF_STORE(ringbuf->read_index,
+                     ringbuf_index_add(ringbuf, read_index, MR_RINGBUF_RECORD_HEAD + record_size));
+    return size;
+}
+
+/**
+ * @brief This function write a record to the ringbuffer.
+ *
+ * @param ringbuf The ringbuffer to be written.
+ * @param buffer The record to be written to ringbuffer.
+ * @param size The size of the record.
+ *
+ * @return The size of the actual write, the record is written entirely or not at all.
+ *
+ * @note A ringbuffer holding records must only be read and written by the record functions.
+ */
+size_t mr_ringbuf_write_record(struct mr_ringbuf *ringbuf, const void *buffer, size_t size)
+{
+    MR_ASSERT(ringbuf != MR_NULL);
+    MR_ASSERT((buffer != MR_NULL) || (size == 0));
+
+    size_t write_index = ringbuf->write_index;
+
+    if ((size == 0) || (size > UINT16_MAX)) {
+        return 0;
+    }
+
+    /* Get the space size */
+    size_t space_size = ringbuf->size -
+                        ringbuf_data_size(ringbuf, MR_RINGBUF_LOAD(ringbuf->read_index), write_index);
+    if (space_size < (MR_RINGBUF_RECORD_HEAD + size)) {
+        return 0;
+    }
+
+    /* Copy the record from the buffer to the ringbuf */
+    ringbuf_put_record(ringbuf, write_index, buffer, size);
+
+    /* Publish the whole record to the consumer */
+    MR_RINGBUF_STORE(ringbuf->write_index, ringbuf_index_add(ringbuf, write_index, MR_RINGBUF_RECORD_HEAD + size));
+    return size;
+}
+
+/**
+ * @brief This function force write a record to the ringbuffer.
+ *
+ * @param ringbuf The ringbuffer to be written.
+ * @param buffer The record to be written to ringbuffer.
+ * @param size The size of the record.
+ *
+ * @return The size of the actual write, the record is written entirely or not at all.
+ *
+ * @note The oldest records are discarded to make room, in lock-free mode the read index belongs to the consumer and
+ *       the record is dropped instead.
+ */
+size_t mr_ringbuf_write_record_force(struct mr_ringbuf *ringbuf, const void *buffer, size_t size)
+{
+#ifdef MR_USING_RINGBUF_SPSC
+    return mr_ringbuf_write_record(ringbuf, buffer, size);
+#else
+    MR_ASSERT(ringbuf != MR_NULL);
+    MR_ASSERT((buffer != MR_NULL) || (size == 0));
+
+    size_t write_index = ringbuf->write_index;
+
+    if ((size == 0) || (size > UINT16_MAX) || ((MR_RINGBUF_RECORD_HEAD + size) > ringbuf->size)) {
+        return 0;
+    }
+
+    /* If the ringbuffer is full, the oldest records are discarded */
+    while ((ringbuf->size - ringbuf_data_size(ringbuf, ringbuf->read_index, write_index)) <
+           (MR_RINGBUF_RECORD_HEAD + size)) {
+        ringbuf->read_index = ringbuf_index_add(ringbuf,
+                                                ringbuf->read_index,
+                                                MR_RINGBUF_RECORD_HEAD +
+                                                ringbuf_get_record_size(ringbuf, ringbuf->read_index));
+    }
+
+    /* Copy the record from the buffer to the ringbuf */
+    ringbuf_put_record(ringbuf, write_index, buffer, size);
+    ringbuf->write_index = ringbuf_index_add(ringbuf, write_index, MR_RINGBUF_RECORD_HEAD + size);
+    return size;
+#endif /* MR_USING_RINGBUF_SPSC */
+}
+
 static int mr_avl_get_height(struct mr_avl *node)
 {
     if (node == MR_NULL) {
@@ -802,3 +1155,103 @@ size_t mr_avl_get_length(struct mr_avl *tree)
     }
     return length;
 }
+
+#ifdef MR_USING_TRACE
+#ifndef MR_CFG_TRACE_NUM
+#define MR_CFG_TRACE_NUM                (64)
+#endif /* MR_CFG_TRACE_NUM */
+#if (MR_CFG_TRACE_NUM & (MR_CFG_TRACE_NUM - 1)) != 0
+#error "MR_CFG_TRACE_NUM must be a power of 2"
+#endif /* (MR_CFG_TRACE_NUM & (MR_CFG_TRACE_NUM - 1)) != 0 */
+static struct mr_trace_event trace_ring[MR_CFG_TRACE_NUM] = {0};   /**< Trace ring */
+static uint32_t trace_index = 0;                                    /**< Next trace event index */
+static volatile int trace_full = MR_FALSE;                          /**< Whether the trace ring is full */
+static volatile int trace_enable = MR_ENABLE;                       /**< Whether the trace is enabled */
+
+/**
+ * @brief This function trace an event.
+ *
+ * @param type The type of the event.
+ * @param start The cycles when the event started (from mr_cycle_get()).
+ * @param obj The object of the event.
+ * @param arg The argument of the event.
+ * @param ret The result of the event.
+ *
+ * @note The oldest event is overwritten when the ring is full, it is safe to be called from interrupts.
+ */
+void mr_trace(uint32_t type, uint32_t start, const void *obj, int arg, int ret)
+{
+    if (trace_enable == MR_DISABLE) {
+        return;
+    }
+
+    uint32_t cycles = mr_cycle_get() - start;
+#if defined(__GNUC__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+    uint32_t index = __atomic_fetch_add(&trace_index, 1, __ATOMIC_RELAXED);
+#else
+    /* Without atomics an interrupt may take the same event, the trace is a best effort */
+    uint32_t index = trace_index++;
+#endif /* defined(__GNUC__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4) */
+    struct mr_trace_event *event = &trace_ring[index & (MR_CFG_TRACE_NUM - 1)];
+
+    event->time = start;
+    event->cycles = cycles;
+    event->obj = (uint32_t)(uintptr_t)obj;
+    event->arg = arg;
+    event->ret = ret;
+    event->type = type;
+    if (index >= (MR_CFG_TRACE_NUM - 1)) {
+        trace_full = MR_TRUE;
+    }
+}
+
+/**
+ * @brief This function get a trace event.
+ *
+ * @param index The index of the event, 0 is the oldest.
+ * @param event The event.
+ *
+ * @return 0 on success, otherwise an error code.
+ *
+ * @note Disable the trace while getting the events, otherwise they may be overwritten.
+ */
+int mr_trace_get_event(size_t index, struct mr_trace_event *event)
+{
+    MR_ASSERT(event != MR_NULL);
+
+    uint32_t next = trace_index;
+    size_t num = (trace_full == MR_TRUE) ? MR_CFG_TRACE_NUM : next;
+
+    if (index >= num) {
+        return MR_ENOTFOUND;
+    }
+    *event = trace_ring[(next - num + index) & (MR_CFG_TRACE_NUM - 1)];
+    return MR_EOK;
+}
+
+/**
+ * @brief This function enable or disable the trace.
+ *
+ * @param enable The enable state.
+ *
+ * @return The previous enable state.
+ */
+int mr_trace_set_enable(int enable)
+{
+    int prev = trace_enable;
+
+    trace_enable = enable;
+    return prev;
+}
+
+/**
+ * @brief This function clear the trace events.
+ */
+void mr_trace_clear(void)
+{
+    mr_interrupt_disable();
+    trace_index = 0;
+    trace_full = MR_FALSE;
+    mr_interrupt_enable();
+}
+#endif /* MR_USING_TRACE */
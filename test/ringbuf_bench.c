@@ -0,0 +1,72 @@
+/*
+ * @copyright (c) 2023-2024, MR Development Team
+ *
+ * @license SPDX-License-Identifier: Apache-2.0
+ *
+ * @date 2024-04-08    MacRsh       First version
+ */
+
+/*
+ * Host micro-benchmark of the per-byte ringbuffer push/pop, as done by the byte-wise read interrupts. Build it once
+ * with and once without MR_USING_RINGBUF_POW2 and compare the cost per byte.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu11 -O2 -I. test/ringbuf_bench.c source/service.c source/memory.c source/device.c \
+ *       -o ringbuf_bench && ./ringbuf_bench
+ *   gcc -std=gnu11 -O2 -I. -DMR_USING_RINGBUF_POW2 test/ringbuf_bench.c source/service.c source/memory.c \
+ *       source/device.c -o ringbuf_bench_pow2 && ./ringbuf_bench_pow2
+ */
+
+#include "include/mr_api.h"
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_BYTES                     (100000000L)                /* Bytes pushed and popped */
+#define BENCH_POOL_SIZE                 (128)                       /* A power of two, the same in both modes */
+#define BENCH_RUNS                      (5)                         /* Runs, the fastest one is reported */
+
+static double bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(void)
+{
+    static uint8_t pool[BENCH_POOL_SIZE];
+    struct mr_ringbuf ringbuf;
+    double best = 0;
+    uint32_t sum = 0;
+
+    mr_ringbuf_init(&ringbuf, pool, sizeof(pool));
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        mr_ringbuf_reset(&ringbuf);
+
+        /* Keep the ringbuffer partly filled, so the indices wrap around as in a receive FIFO */
+        double start = bench_now();
+        for (long i = 0; i < BENCH_BYTES; i++) {
+            uint8_t data;
+
+            mr_ringbuf_push(&ringbuf, (uint8_t)i);
+            if ((i & 1) != 0) {
+                mr_ringbuf_pop(&ringbuf, &data);
+                sum += data;
+                mr_ringbuf_pop(&ringbuf, &data);
+                sum += data;
+            }
+        }
+        double ns = (bench_now() - start) / BENCH_BYTES;
+        if ((run == 0) || (ns < best)) {
+            best = ns;
+        }
+    }
+
+#ifdef MR_USING_RINGBUF_POW2
+    printf("ringbuf bench (pow2): %.2f ns per byte pushed and popped (%u)\r\n", best, sum);
+#else
+    printf("ringbuf bench: %.2f ns per byte pushed and popped (%u)\r\n", best, sum);
+#endif /* MR_USING_RINGBUF_POW2 */
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * @copyright (c) 2023-2024, MR Development Team
+ *
+ * @license SPDX-License-Identifier: Apache-2.0
+ *
+ * @date 2024-04-08    MacRsh       First version
+ */
+
+/*
+ * Host stress test of the single-producer single-consumer ringbuffer, the producer and the consumer run on two
+ * threads and use every write and read function in turn, the consumer checks that the byte sequence is intact.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu11 -O2 -g -fsanitize=thread -I. -DMR_USING_RINGBUF_SPSC test/ringbuf_spsc_test.c \
+ *       source/service.c source/memory.c source/device.c -lpthread -o ringbuf_spsc_test && ./ringbuf_spsc_test
+ * Add -DMR_USING_RINGBUF_POW2 to test the power of two mode.
+ */
+
+#include "include/mr_api.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define TEST_BYTES                      (20000000UL)                /* Bytes transferred */
+#define TEST_POOL_SIZE                  (97)                        /* Odd size, so the wrap is not aligned */
+
+static struct mr_ringbuf ringbuf;
+static uint8_t pool[TEST_POOL_SIZE];
+
+/* A small xorshift, rand() is not thread safe */
+static uint32_t test_rand(uint32_t *seed)
+{
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
+
+static void *test_producer(void *args)
+{
+    uint32_t seed = 0x12345678;
+    unsigned long seq = 0;
+    uint8_t buf[37];
+
+    while (seq < TEST_BYTES) {
+        size_t count = test_rand(&seed) % sizeof(buf) + 1;
+        size_t size = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            buf[i] = (uint8_t)(seq + i);
+        }
+        switch (test_rand(&seed) % 3) {
+            case 0: {
+                size = mr_ringbuf_push(&ringbuf, buf[0]);
+                break;
+            }
+            case 1: {
+                size = mr_ringbuf_write(&ringbuf, buf, count);
+                break;
+            }
+            default: {
+                struct mr_ringbuf_span span[2];
+
+                size_t reserved = mr_ringbuf_write_reserve(&ringbuf, span, count);
+                for (size_t i = 0; (i < 2) && (size < reserved); i++) {
+                    memcpy(span[i].buffer, buf + size, span[i].size);
+                    size += span[i].size;
+                }
+                mr_ringbuf_write_commit(&ringbuf, size);
+                break;
+            }
+        }
+        seq += size;
+
+        /* Let the consumer run when the ringbuffer is full, the host may have a single core */
+        if (size == 0) {
+            sched_yield();
+        }
+    }
+    return MR_NULL;
+}
+
+int main(void)
+{
+    uint32_t seed = 0x87654321;
+    unsigned long seq = 0;
+    uint8_t buf[41];
+    pthread_t thread;
+
+    mr_ringbuf_init(&ringbuf, pool, sizeof(pool));
+    if (pthread_create(&thread, MR_NULL, test_producer, MR_NULL) != 0) {
+        printf("ringbuf spsc: thread create failed\r\n");
+        return 1;
+    }
+
+    while (seq < TEST_BYTES) {
+        size_t count = test_rand(&seed) % sizeof(buf) + 1;
+        size_t size = 0;
+
+        switch (test_rand(&seed) % 3) {
+            case 0: {
+                size = mr_ringbuf_pop(&ringbuf, buf);
+                break;
+            }
+            case 1: {
+                size = mr_ringbuf_read(&ringbuf, buf, count);
+                break;
+            }
+            default: {
+                struct mr_ringbuf_span span[2];
+
+                size_t peeked = mr_ringbuf_read_peek(&ringbuf, span, count);
+                for (size_t i = 0; (i < 2) && (size < peeked); i++) {
+                    memcpy(buf + size, span[i].buffer, span[i].size);
+                    size += span[i].size;
+                }
+                mr_ringbuf_read_consume(&ringbuf, size);
+                break;
+            }
+        }
+        for (size_t i = 0; i < size; i++) {
+            if (buf[i] != (uint8_t)(seq + i)) {
+                printf("ringbuf spsc: FAIL at byte %lu\r\n", seq + i);
+                return 1;
+            }
+        }
+        seq += size;
+        if (size == 0) {
+            sched_yield();
+        }
+    }
+    pthread_join(thread, MR_NULL);
+
+    printf("ringbuf spsc: %lu bytes ok\r\n", seq);
+    return 0;
+}
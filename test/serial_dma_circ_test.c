@@ -0,0 +1,160 @@
+/*
+ * @copyright (c) 2023-2024, MR Development Team
+ *
+ * @license SPDX-License-Identifier: Apache-2.0
+ *
+ * @date 2024-04-08    MacRsh       First version
+ */
+
+/*
+ * Host test of the serial circular DMA receive, a simulated DMA writes a byte sequence into the circular buffer and
+ * reports its position on half-transfer, transfer-complete and idle-line, the reader checks that the sequence is
+ * intact and that an overrun is counted as lost.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu11 -g -fsanitize=address,undefined -I. -DMR_USING_SERIAL -DMR_USING_SERIAL_DMA \
+ *       -DMR_USING_SERIAL_DMA_CIRC test/serial_dma_circ_test.c device/serial.c source/device.c source/service.c \
+ *       source/memory.c -o serial_dma_circ_test && ./serial_dma_circ_test
+ */
+
+#include "include/device/mr_serial.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_DMA_BUFSZ                  (256)                       /* Circular DMA buffer size */
+#define TEST_ROUNDS                     (200000)                    /* Receive and read rounds */
+
+static struct mr_serial serial;
+static uint8_t *dma_buf = MR_NULL;
+static size_t dma_bufsz = 0;
+static size_t dma_pos = 0;
+static uint8_t seq_tx = 0;
+static uint8_t seq_rx = 0;
+
+static int test_configure(struct mr_serial *serial, struct mr_serial_config *config)
+{
+    return MR_EOK;
+}
+
+static int test_read(struct mr_serial *serial, uint8_t *data)
+{
+    return MR_EIO;
+}
+
+static int test_write(struct mr_serial *serial, uint8_t data)
+{
+    return MR_EOK;
+}
+
+static void test_nop(struct mr_serial *serial)
+{
+
+}
+
+static void test_stop_dma_rx(struct mr_serial *serial)
+{
+    dma_buf = MR_NULL;
+}
+
+static void test_start_dma_rx_circ(struct mr_serial *serial, uint8_t *buf, size_t count)
+{
+    dma_buf = buf;
+    dma_bufsz = count;
+    dma_pos = 0;
+}
+
+static struct mr_serial_ops test_ops = {.configure = test_configure,
+                                       .read = test_read,
+                                       .write = test_write,
+                                       .start_tx = test_nop,
+                                       .stop_tx = test_nop,
+                                       .stop_dma_rx = test_stop_dma_rx,
+                                       .start_dma_rx_circ = test_start_dma_rx_circ};
+static struct mr_drv test_drv = {&test_ops, MR_NULL};
+
+static void test_report(void)
+{
+    size_t position = dma_pos;
+
+    mr_dev_isr(&serial.dev, MR_ISR_SERIAL_RD_DMA_POS, &position);
+}
+
+/* Receive bytes as the DMA does, with the half-transfer and transfer-complete reports, then an idle-line report */
+static void test_receive(size_t count)
+{
+    while (count--) {
+        dma_buf[dma_pos++] = seq_tx++;
+        if (dma_pos == (dma_bufsz / 2)) {
+            test_report();
+        }
+        if (dma_pos == dma_bufsz) {
+            test_report();
+            dma_pos = 0;
+        }
+    }
+    test_report();
+}
+
+static int test_check(const uint8_t *buf, ssize_t size)
+{
+    for (ssize_t i = 0; i < size; i++) {
+        if (buf[i] != seq_rx++) {
+            return MR_EIO;
+        }
+    }
+    return MR_EOK;
+}
+
+int main(void)
+{
+    static uint64_t heap[1024];
+    size_t bufsz = TEST_DMA_BUFSZ, lost = 0;
+    uint8_t buf[TEST_DMA_BUFSZ + 44];
+    ssize_t size;
+
+    mr_heap_add_region(heap, sizeof(heap), MR_HEAP_DMA, 0);
+    mr_serial_register(&serial, "uart1", &test_drv);
+    int desc = mr_dev_open("uart1", MR_O_RDWR);
+    if ((desc < 0) || (mr_dev_ioctl(desc, MR_IOC_SERIAL_SET_RD_DMA_BUFSZ, &bufsz) < 0) || (dma_buf == MR_NULL)) {
+        printf("serial dma circ: open failed\r\n");
+        return 1;
+    }
+
+    /* Receive up to 119 bytes and read them all with random sizes, nothing is lost */
+    srand(1);
+    for (int i = 0; i < TEST_ROUNDS; i++) {
+        test_receive(rand() % 120);
+        size = mr_dev_read(desc, buf, rand() % sizeof(buf));
+        while (size > 0) {
+            if (test_check(buf, size) < 0) {
+                printf("serial dma circ: FAIL at round %d\r\n", i);
+                return 1;
+            }
+            size = mr_dev_read(desc, buf, sizeof(buf));
+        }
+    }
+    mr_dev_ioctl(desc, MR_IOC_SERIAL_GET_RD_DMA_LOST, &lost);
+    if (lost != 0) {
+        printf("serial dma circ: FAIL, %zu bytes lost without overrun\r\n", lost);
+        return 1;
+    }
+
+    /* Overrun, the newest buffer of data remains and the rest is counted as lost */
+    test_receive(1000);
+    seq_rx = (uint8_t)(seq_tx - TEST_DMA_BUFSZ);
+    size = mr_dev_read(desc, buf, sizeof(buf));
+    mr_dev_ioctl(desc, MR_IOC_SERIAL_GET_RD_DMA_LOST, &lost);
+    if ((size != TEST_DMA_BUFSZ) || (test_check(buf, size) < 0) || (lost != (1000 - TEST_DMA_BUFSZ))) {
+        printf("serial dma circ: FAIL, overrun read %zd lost %zu\r\n", size, lost);
+        return 1;
+    }
+
+    mr_dev_close(desc);
+    if (dma_buf != MR_NULL) {
+        printf("serial dma circ: FAIL, DMA not stopped on close\r\n");
+        return 1;
+    }
+
+    printf("serial dma circ: ok\r\n");
+    return 0;
+}
@@ -248,6 +248,7 @@ class Eclipse:
         . = ALIGN(4);
         KEEP(*(SORT(mr_auto_init.*)))
         KEEP(*(SORT(mr_msh_cmd.*)))
+        KEEP(*(SORT(mr_dev_static.*)))
         . = ALIGN(4);
     """
                         back = content[pos:]
@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+
+"""
+@copyright (c) 2023-2024, MR Development Team
+
+@license SPDX-License-Identifier: Apache-2.0
+
+@date 2024-03-25    MacRsh       First version
+"""
+
+import sys
+import json
+import argparse
+
+# Trace event types (MR_TRACE_* in mr_def.h)
+TRACE_TYPES = {
+    1: ('open', 'device'),
+    2: ('close', 'device'),
+    3: ('read', 'device'),
+    4: ('write', 'device'),
+    5: ('ioctl', 'device'),
+    6: ('isr', 'interrupt'),
+    7: ('lock', 'device'),
+    8: ('malloc', 'memory'),
+    9: ('free', 'memory'),
+}
+
+
+def parse_dump(lines):
+    devices = {}
+    events = []
+    for line in lines:
+        fields = line.split()
+        if len(fields) == 3 and fields[0] == 'D':
+            # D <address> <path>
+            devices[int(fields[1], 16)] = fields[2]
+        elif len(fields) == 7 and fields[0] == 'E':
+            # E <type> <time> <cycles> <object> <argument> <result>
+            events.append({
+                'type': int(fields[1]),
+                'time': int(fields[2], 16),
+                'cycles': int(fields[3], 16),
+                'obj': int(fields[4], 16),
+                'arg': int(fields[5]),
+                'ret': int(fields[6]),
+            })
+    return devices, events
+
+
+def to_chrome_trace(devices, events, freq):
+    trace_events = []
+    wrap = 0
+    last_time = None
+    first_time = events[0]['time'] if events else 0
+    for event in events:
+        # The cycle counter is 32 bits, the events are in order so a big step back is a wrap around
+        if (last_time is not None) and (event['time'] + wrap < last_time - (1 << 31)):
+            wrap += 1 << 32
+        time = event['time'] + wrap
+        last_time = time
+        time -= first_time
+
+        name, cat = TRACE_TYPES.get(event['type'], ('unknown', 'unknown'))
+        if cat == 'memory':
+            thread = 'heap'
+        elif cat == 'interrupt':
+            thread = 'isr'
+        else:
+            thread = devices.get(event['obj'], '0x%08x' % event['obj'])
+        if cat != 'memory':
+            name = '%s %s' % (name, devices.get(event['obj'], '0x%08x' % event['obj']))
+        trace_events.append({
+            'name': name,
+            'cat': cat,
+            'ph': 'X',
+            'ts': time / freq,
+            'dur': event['cycles'] / freq,
+            'pid': 0,
+            'tid': thread,
+            'args': {'obj': '0x%08x' % event['obj'], 'arg': event['arg'], 'ret': event['ret']},
+        })
+    return {'traceEvents': trace_events, 'displayTimeUnit': 'ns'}
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description="Decode the msh 'trace' dump into Chrome trace JSON "
+                                                 "(open it in chrome://tracing or Perfetto)")
+    parser.add_argument("-i", "--input", help="Captured output of the msh 'trace' command (default stdin)")
+    parser.add_argument("-o", "--output", help="Chrome trace JSON file (default stdout)")
+    parser.add_argument("-f", "--freq", type=float, default=1.0,
+                        help="Frequency of mr_cycle_get() in MHz (default 1, one cycle is one us)")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, 'r', errors='ignore') as f:
+            devices, events = parse_dump(f)
+    else:
+        devices, events = parse_dump(sys.stdin)
+
+    trace = to_chrome_trace(devices, events, args.freq)
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(trace, f, indent=1)
+    else:
+        json.dump(trace, sys.stdout, indent=1)